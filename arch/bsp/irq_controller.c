@@ -0,0 +1,307 @@
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <arch/bsp/irq_controller.h>
+#include <arch/cpu/irq_flags.h>
+#include <arch/cpu/pmu.h>
+#include <lib/kprintf.h>
+
+#define IRQ_CONTROLLER_BASE   (0x7E00B200 - 0x3F000000)
+#define LOCAL_CONTROLLER_BASE 0x40000000
+
+typedef struct {
+	volatile uint32_t IRQBasicPending;
+	volatile uint32_t IRQPending1;
+	volatile uint32_t IRQPending2;
+	volatile uint32_t FIQControl;
+	volatile uint32_t EnableIRQs1;
+	volatile uint32_t EnableIRQs2;
+	volatile uint32_t EnableBasicIRQs;
+	volatile uint32_t DisableIRQs1;
+	volatile uint32_t DisableIRQs2;
+	volatile uint32_t DisableBasicIRQs;
+} GPU_Interrupt_Controller;
+
+static_assert(offsetof(GPU_Interrupt_Controller, DisableBasicIRQs) == 0x24);
+
+static volatile GPU_Interrupt_Controller *const gpu_interrupt =
+	(GPU_Interrupt_Controller *)IRQ_CONTROLLER_BASE;
+
+/* BCM2836 per core interrupt controller, only core 0 is used */
+typedef struct {
+	volatile uint32_t control;
+	volatile uint32_t unused0;
+	volatile uint32_t core_timer_prescaler;
+	volatile uint32_t gpu_routing;
+	volatile uint32_t pmu_routing_set;
+	volatile uint32_t pmu_routing_clear;
+	volatile uint32_t unused1;
+	volatile uint32_t core_timer_ls;
+	volatile uint32_t core_timer_ms;
+	volatile uint32_t local_irq_routing;
+	volatile uint32_t unused2;
+	volatile uint32_t axi_counters;
+	volatile uint32_t axi_irq;
+	volatile uint32_t local_timer_control;
+	volatile uint32_t local_timer_write;
+	volatile uint32_t unused3;
+	volatile uint32_t timer_int_control[4];
+	volatile uint32_t mailbox_int_control[4];
+	volatile uint32_t irq_source[4];
+	volatile uint32_t fiq_source[4];
+	volatile uint32_t mailbox_set[4][4];
+	volatile uint32_t mailbox_clear[4][4];
+} Local_Interrupt_Controller;
+
+static_assert(offsetof(Local_Interrupt_Controller, timer_int_control) == 0x40);
+static_assert(offsetof(Local_Interrupt_Controller, irq_source) == 0x60);
+static_assert(offsetof(Local_Interrupt_Controller, mailbox_clear) == 0xC0);
+
+static volatile Local_Interrupt_Controller *const local_intc =
+	(Local_Interrupt_Controller *)LOCAL_CONTROLLER_BASE;
+
+/* Core IRQ source register */
+#define LOCAL_TIMER_MASK   0x00Fu
+#define LOCAL_MAILBOX_BASE 4
+#define LOCAL_MAILBOX_MASK 0x0F0u
+#define LOCAL_SOURCE_GPU   (1u << 8)
+#define LOCAL_SOURCE_PMU   (1u << 9)
+#define LOCAL_SOURCE_MASK  0xFFFu
+
+#define FIQ_CONTROL_ENABLE (1u << 7)
+
+/* Basic pending register */
+#define BASIC_ARM_MASK	    0xFFu
+#define BASIC_PENDING_1	    (1u << 8)
+#define BASIC_PENDING_2	    (1u << 9)
+#define BASIC_SHORTCUT_BASE 10
+#define BASIC_SHORTCUT_MASK (0x7FFu << BASIC_SHORTCUT_BASE)
+
+/* GPU IRQs that are also reported as shortcut bits 10-20 */
+static const uint8_t shortcut_irqs[] = { 7, 9, 10, 18, 19, 53, 54, 55, 56, 57, 62 };
+
+#define SHORTCUT_MASK_1 ((1u << 7) | (1u << 9) | (1u << 10) | (1u << 18) | (1u << 19))
+#define SHORTCUT_MASK_2                                                                   \
+	((1u << (53 - 32)) | (1u << (54 - 32)) | (1u << (55 - 32)) | (1u << (56 - 32)) | \
+	 (1u << (57 - 32)) | (1u << (62 - 32)))
+
+struct irq_desc {
+	irq_handler_t handler;
+	void	     *ctx;
+	uint32_t      count;
+	uint32_t      cycles_max;
+	uint64_t      cycles_total;
+};
+
+static struct irq_desc irq_table[IRQ_COUNT];
+static uint32_t	       unhandled_irqs	   = 0;
+static uint32_t	       dispatch_cycles_max = 0;
+
+static volatile uint32_t *enable_reg(unsigned int irq)
+{
+	if (irq < 32) {
+		return &gpu_interrupt->EnableIRQs1;
+	} else if (irq < 64) {
+		return &gpu_interrupt->EnableIRQs2;
+	}
+	return &gpu_interrupt->EnableBasicIRQs;
+}
+
+static volatile uint32_t *disable_reg(unsigned int irq)
+{
+	if (irq < 32) {
+		return &gpu_interrupt->DisableIRQs1;
+	} else if (irq < 64) {
+		return &gpu_interrupt->DisableIRQs2;
+	}
+	return &gpu_interrupt->DisableBasicIRQs;
+}
+
+static void irqc_local_source_enable(unsigned int source, bool enabled)
+{
+	uint32_t	   bit;
+	volatile uint32_t *reg;
+
+	if ((1u << source) & LOCAL_TIMER_MASK) {
+		reg = &local_intc->timer_int_control[0];
+		bit = 1u << source;
+	} else if ((1u << source) & LOCAL_MAILBOX_MASK) {
+		reg = &local_intc->mailbox_int_control[0];
+		bit = 1u << (source - LOCAL_MAILBOX_BASE);
+	} else if ((1u << source) & LOCAL_SOURCE_PMU) {
+		/* Bit 0 routes the PMU IRQ to core 0 */
+		if (enabled) {
+			local_intc->pmu_routing_set = 1;
+		} else {
+			local_intc->pmu_routing_clear = 1;
+		}
+		return;
+	} else {
+		return;
+	}
+
+	if (enabled) {
+		*reg |= bit;
+	} else {
+		*reg &= ~bit;
+	}
+}
+
+static void irq_set_enabled(unsigned int irq, bool enabled)
+{
+	if (irq >= IRQ_LOCAL(0)) {
+		irqc_local_source_enable(irq - IRQ_LOCAL(0), enabled);
+	} else if (enabled) {
+		*enable_reg(irq) = 1u << (irq % 32);
+	} else {
+		*disable_reg(irq) = 1u << (irq % 32);
+	}
+}
+
+int request_irq(unsigned int irq, irq_handler_t handler, void *ctx)
+{
+	if (irq >= IRQ_COUNT || !handler || irq_table[irq].handler) {
+		return -1;
+	}
+
+	irq_table[irq].handler = handler;
+	irq_table[irq].ctx     = ctx;
+
+	irq_set_enabled(irq, true);
+	return 0;
+}
+
+void free_irq(unsigned int irq)
+{
+	if (irq >= IRQ_COUNT) {
+		return;
+	}
+
+	irq_set_enabled(irq, false);
+	irq_table[irq].handler = nullptr;
+	irq_table[irq].ctx     = nullptr;
+}
+
+int request_fiq(unsigned int irq)
+{
+	if (irq >= IRQ_LOCAL(0) || (gpu_interrupt->FIQControl & FIQ_CONTROL_ENABLE)) {
+		return -1;
+	}
+
+	gpu_interrupt->FIQControl = FIQ_CONTROL_ENABLE | irq;
+	return 0;
+}
+
+void free_fiq(void)
+{
+	gpu_interrupt->FIQControl = 0;
+}
+
+void irq_controller_raise_mailbox(unsigned int mailbox)
+{
+	local_intc->mailbox_set[0][mailbox] = 1;
+}
+
+static void handle_irq(unsigned int irq)
+{
+	struct irq_desc *desc = &irq_table[irq];
+
+	if (!desc->handler) {
+		/* Nobody will acknowledge it, keep it from firing forever */
+		irq_set_enabled(irq, false);
+		unhandled_irqs++;
+		return;
+	}
+
+	if (irq >= IRQ_LOCAL(LOCAL_MAILBOX_BASE) && irq < IRQ_LOCAL(LOCAL_MAILBOX_BASE + 4)) {
+		local_intc->mailbox_clear[0][irq - IRQ_LOCAL(LOCAL_MAILBOX_BASE)] = ~0u;
+	}
+
+	uint32_t start = pmu_cycles();
+	desc->handler(desc->ctx);
+	uint32_t cycles = pmu_cycles() - start;
+
+	desc->count++;
+	desc->cycles_total += cycles;
+	if (cycles > desc->cycles_max) {
+		desc->cycles_max = cycles;
+	}
+}
+
+static inline unsigned int highest_bit(uint32_t bits)
+{
+	return 31 - __builtin_clz(bits);
+}
+
+static void dispatch_bits(uint32_t bits, unsigned int base)
+{
+	while (bits) {
+		unsigned int bit = highest_bit(bits);
+		bits &= ~(1u << bit);
+		handle_irq(base + bit);
+	}
+}
+
+static void dispatch_gpu(void)
+{
+	uint32_t basic = gpu_interrupt->IRQBasicPending;
+
+	dispatch_bits(basic & BASIC_ARM_MASK, IRQ_BASIC(0));
+
+	uint32_t shortcuts = (basic & BASIC_SHORTCUT_MASK) >> BASIC_SHORTCUT_BASE;
+	while (shortcuts) {
+		unsigned int bit = highest_bit(shortcuts);
+		shortcuts &= ~(1u << bit);
+		handle_irq(shortcut_irqs[bit]);
+	}
+
+	/* Shortcut IRQs were already serviced above */
+	if (basic & BASIC_PENDING_1) {
+		dispatch_bits(gpu_interrupt->IRQPending1 & ~SHORTCUT_MASK_1, 0);
+	}
+	if (basic & BASIC_PENDING_2) {
+		dispatch_bits(gpu_interrupt->IRQPending2 & ~SHORTCUT_MASK_2, 32);
+	}
+}
+
+void irq_controller_dispatch(void)
+{
+	uint32_t start	= pmu_cycles();
+	uint32_t source = local_intc->irq_source[0];
+
+	if (source & LOCAL_SOURCE_GPU) {
+		dispatch_gpu();
+	}
+	dispatch_bits(source & LOCAL_SOURCE_MASK & ~LOCAL_SOURCE_GPU, IRQ_LOCAL(0));
+
+	/* The whole dispatch runs with IRQs off */
+	uint32_t cycles = pmu_cycles() - start;
+	if (cycles > dispatch_cycles_max) {
+		dispatch_cycles_max = cycles;
+	}
+}
+
+uint32_t irq_controller_dispatch_max_reset(void)
+{
+	uint32_t flags = local_irq_save();
+	uint32_t max   = dispatch_cycles_max;
+
+	dispatch_cycles_max = 0;
+	local_irq_restore(flags);
+	return max;
+}
+
+void irq_controller_print_stats(void)
+{
+	kprintf("\nIRQ    count   kcycles max cycles\n");
+	for (unsigned int irq = 0; irq < IRQ_COUNT; irq++) {
+		struct irq_desc *desc = &irq_table[irq];
+		if (!desc->count) {
+			continue;
+		}
+		kprintf("%2u %8u %9u %9u\n", irq, desc->count,
+			(uint32_t)(desc->cycles_total >> 10), desc->cycles_max);
+	}
+	kprintf("unhandled: %u, longest dispatch: %u cycles\n", unhandled_irqs,
+		dispatch_cycles_max);
+}
@@ -4,14 +4,15 @@
 #include <config.h>
 #include <arch/bsp/uart.h>
 #include <arch/bsp/systimer.h>
+#include <arch/bsp/irq_controller.h>
+#include <kernel/kconfig.h>
+#include <kernel/tick.h>
 
 #define SYSTIMER_BUS_BASE   0x7E003000
 #define BUS_BASE	    0x7E000000
 #define CPU_PERIPHERAL_BASE 0x3F000000
 #define SYSTIMER_BASE	    (CPU_PERIPHERAL_BASE + (SYSTIMER_BUS_BASE - BUS_BASE))
 
-static const unsigned int IRQ_CONTROLLER_BASE = 0x7E00B000 - 0x3F000000;
-
 typedef struct {
 	unsigned int CS;
 	unsigned int CLO;
@@ -22,42 +23,72 @@ typedef struct {
 	unsigned int C3;
 } SystemTimer;
 
-#define SYSTIMER_CS_M1	     (1u << 1)
-#define TIMER_INTERRUPT_MASK (1 << 1)
-#define UART_INTERRUPT_MASK  (1 << 25)
-#define TIMER_STATUS_1	     (1 << 1)
-#define TIMER_STATUS_3	     (1 << 3)
-
-struct irq_controller {
-	unsigned int unused[128];
-	unsigned int IRQ_basic_pending;
-	unsigned int PENDING_1;
-	unsigned int PENDING_2;
-	unsigned int FIQ_control;
-	unsigned int ENABLE_1;
-	unsigned int ENABLE_2;
-};
-
-static volatile struct irq_controller *const irq_controller_instance =
-	(struct irq_controller *)IRQ_CONTROLLER_BASE;
+#define TIMER_STATUS_1 (1 << 1)
+#define TIMER_STATUS_3 (1 << 3)
 
 volatile SystemTimer *const systimer = (volatile SystemTimer *)SYSTIMER_BASE;
 
+static unsigned int irq_latency_max = 0;
+
+static void systimer_irq_handler(void *ctx)
+{
+	(void)ctx;
+	systimer_handle_irq();
+	tick_handle_periodic();
+}
+
 void systimer_init(void)
 {
-	irq_controller_instance->ENABLE_1 |= TIMER_INTERRUPT_MASK;
-	irq_controller_instance->ENABLE_2 |= UART_INTERRUPT_MASK;
-	systimer->CS |= TIMER_STATUS_1;
-	unsigned int counter = systimer->CLO;
-	systimer->C1	     = counter + TIMER_INTERVAL;
+	if (TICK_GENERIC_TIMER) {
+		return;
+	}
+
+	request_irq(IRQ_SYSTIMER_1, systimer_irq_handler, nullptr);
+	systimer->CS = TIMER_STATUS_1;
+	systimer->C1 = systimer->CLO + TIMER_INTERVAL;
 }
 
 bool systimer_handle_irq(void)
 {
-	kprintf("!");
 	unsigned int counter = systimer->CLO;
-	unsigned int new_c1  = counter + TIMER_INTERVAL;
-	systimer->C1	     = new_c1;
-	systimer->CS |= TIMER_STATUS_1;
+	unsigned int latency = counter - systimer->C1;
+	if (latency > irq_latency_max) {
+		irq_latency_max = latency;
+	}
+
+	// Re-arm from the programmed deadline so the handler delay does not
+	// accumulate; skip ticks that already passed
+	unsigned int next = systimer->C1 + TIMER_INTERVAL;
+	while ((int)(counter - next) >= 0) {
+		next += TIMER_INTERVAL;
+	}
+	systimer->C1 = next;
+	// CS is write-1-to-clear, a read-modify-write would ack other channels
+	systimer->CS = TIMER_STATUS_1;
 	return false;
 }
+
+void systimer_c3_arm(uint32_t deadline)
+{
+	systimer->C3 = deadline;
+}
+
+void systimer_c3_ack(void)
+{
+	systimer->CS = TIMER_STATUS_3;
+}
+
+uint32_t systimer_now(void)
+{
+	return systimer->CLO;
+}
+
+uint32_t systimer_irq_latency_max(void)
+{
+	return irq_latency_max;
+}
+
+void systimer_irq_latency_reset(void)
+{
+	irq_latency_max = 0;
+}
@@ -9,13 +9,20 @@
 #include <stddef.h>
 #include <lib/kprintf.h>
 #include <lib/ringbuffer.h>
+#include <kernel/wait.h>
+#include <arch/bsp/irq_controller.h>
+#include <arch/cpu/fiq.h>
+#include <kernel/kconfig.h>
+#include <kernel/workqueue.h>
+#include <kernel/input_pool.h>
+#include <kernel/poll.h>
+#include <kernel/debug.h>
 #include "arch/bsp/uart.h"
 
 #define PL011_BUS_BASE	    0x7E201000
 #define BUS_BASE	    0x7E000000
 #define CPU_PERIPHERAL_BASE 0x3F000000
 #define PL011_BASE	    ((PL011_BUS_BASE - BUS_BASE) + CPU_PERIPHERAL_BASE)
-#define UART_IRQ_BIT	    (1 << 25)
 
 typedef struct {
 	volatile uint32_t DR;
@@ -35,9 +42,8 @@ typedef struct {
 	volatile uint32_t ICR;
 	volatile uint32_t DMACR;
 } UART;
-bool					 irq_debug     = false;
-volatile GPU_Interrupt_Controller *const gpu_interrupt = (GPU_Interrupt_Controller *)0x3F00B200;
-static volatile UART *const		 uart	       = (UART *)(PL011_BASE);
+bool			    irq_debug = false;
+static volatile UART *const uart      = (UART *)(PL011_BASE);
 
 #define PL011_FR_TXFF (1 << 5)
 #define PL011_FR_RXFE (1 << 4)
@@ -47,16 +53,40 @@ static volatile UART *const		 uart	       = (UART *)(PL011_BASE);
 
 #define PL011_CR_RXE	(1 << 9)
 #define PL011_CR_TXE	(1 << 8)
+#define PL011_CR_LBE	(1 << 7)
 #define PL011_CR_UARTEN (1 << 0)
 
 #define PL011_INT_RXIM (1 << 4)
+#define PL011_INT_TXIM (1 << 5)
 #define PL011_INT_RTIM (1 << 6)
-#define PL011_INT_OEIM (1 << 1)
+#define PL011_INT_OEIM (1 << 10)
 #define PL011_INT_RX   (1 << 4)
+#define PL011_INT_TX   (1 << 5)
 #define PL011_INT_RT   (1 << 6)
-#define PL011_INT_OE   (1 << 1)
+#define PL011_INT_OE   (1 << 10)
 
 create_ringbuffer(uart_rx_buffer, UART_INPUT_BUFFER_SIZE);
+static wait_queue_t uart_rx_wait = WAIT_QUEUE_INIT(uart_rx_wait);
+
+/* Raw input, filled by the IRQ top half or uart_fiq_handler */
+create_ringbuffer(uart_input_buffer, UART_INPUT_BUFFER_SIZE);
+static_assert(offsetof(struct ring_buff, head) == 0 && offsetof(struct ring_buff, tail) == 4 &&
+	      offsetof(struct ring_buff, size) == 8 && offsetof(struct ring_buff, mask) == 12);
+
+void		uart_fiq_handler(void);
+extern uint32_t uart_fiq_overruns;
+extern uint32_t uart_fiq_dropped;
+
+static uint32_t rx_overruns	    = 0;
+static uint32_t rx_dropped	    = 0; // raw input buffer full in the IRQ top half
+static uint32_t rx_buffer_overflows = 0; // uart_rx_buffer full, nobody calls getc
+static uint32_t tx_chars	    = 0;
+static uint32_t tx_writes	    = 0;
+
+static void uart_fiq_input_handler(void *ctx);
+static void uart_input_work_func(struct work *work);
+
+static struct work uart_input_work = WORK_INIT(uart_input_work, uart_input_work_func);
 
 void uart_init(void)
 {
@@ -70,7 +100,29 @@ void uart_init(void)
 
 	uart->CR = PL011_CR_UARTEN | PL011_CR_TXE | PL011_CR_RXE;
 
-	gpu_interrupt->EnableIRQs2 |= UART_IRQ_BIT;
+	if (UART_RX_FIQ) {
+		struct fiq_regs regs = {
+			.r8  = (uint32_t)uart,
+			.r9  = (uint32_t)uart_input_buffer,
+			.r10 = (uint32_t)uart_input_buffer->buffer,
+		};
+		fiq_set_regs(&regs);
+		fiq_set_handler(uart_fiq_handler);
+		request_irq(IRQ_LOCAL_MAILBOX0, uart_fiq_input_handler, nullptr);
+		request_fiq(IRQ_UART);
+		fiq_enable();
+	} else {
+		request_irq(IRQ_UART, uart_irq_handler, nullptr);
+	}
+}
+
+void uart_loopback(bool enable)
+{
+	if (enable) {
+		uart->CR |= PL011_CR_LBE;
+	} else {
+		uart->CR &= ~PL011_CR_LBE;
+	}
 }
 
 void uart_putc(char input)
@@ -87,10 +139,18 @@ void uart_puts(const char *string)
 	}
 }
 
-char uart_getc(void)
+void uart_write(const char *buf, uint32_t len)
 {
-	while (buff_is_empty(uart_rx_buffer)) {
+	tx_writes++;
+	tx_chars += len;
+	for (uint32_t i = 0; i < len; i++) {
+		uart_putc(buf[i]);
 	}
+}
+
+char uart_getc(void)
+{
+	wait_event(&uart_rx_wait, !buff_is_empty(uart_rx_buffer));
 	return buff_getc(uart_rx_buffer);
 }
 
@@ -107,9 +167,58 @@ bool uart_data_available(void)
 	return !buff_is_empty(uart_rx_buffer);
 }
 
+void uart_get_rx_stats(struct uart_rx_stats *stats)
+{
+	stats->overruns	    = rx_overruns + uart_fiq_overruns;
+	stats->input_drops  = rx_dropped + uart_fiq_dropped;
+	stats->rx_overflows = rx_buffer_overflows;
+}
+
+void uart_print_stats(void)
+{
+	struct uart_rx_stats rx;
+	uart_get_rx_stats(&rx);
+
+	kprintf("uart rx via %s: overruns %u, input drops %u, rx buffer overflows %u\n",
+		UART_RX_FIQ ? "fiq" : "irq", rx.overruns, rx.input_drops, rx.rx_overflows);
+	kprintf("uart tx: %u chars in %u writes\n", tx_chars, tx_writes);
+}
+
 #include <user/main.h>
-void uart_irq_handler(void)
+static void uart_rx_char(char c)
 {
+	switch (c) {
+	case 'S':
+		do_svc();
+		break;
+	case 'P':
+		do_prefetch_abort();
+		break;
+	case 'A':
+		do_data_abort();
+		break;
+	case 'U':
+		do_undef();
+		break;
+	default:
+		if (!debug_key(c)) {
+			input_event_post(c);
+		}
+		break;
+	}
+
+	if (buff_putc(uart_rx_buffer, c)) {
+		rx_buffer_overflows++;
+	}
+}
+
+/* Top half: only drains the FIFO, the input is processed by uart_input_work */
+void uart_irq_handler(void *ctx)
+{
+	(void)ctx;
+	if (uart->MIS & PL011_INT_OE) {
+		rx_overruns++;
+	}
 	if (uart->MIS & (PL011_INT_RX | PL011_INT_RT)) {
 		while (!(uart->FR & PL011_FR_RXFE)) {
 			uint32_t data = uart->DR;
@@ -118,37 +227,49 @@ void uart_irq_handler(void)
 				(void)error_clear;
 				continue;
 			}
-			char c = (char)(data & 0xFF);
-
-			switch (c) {
-			case 'S':
-				do_svc();
-				break;
-			case 'P':
-				do_prefetch_abort();
-				break;
-			case 'A':
-				do_data_abort();
-				break;
-			case 'U':
-				do_undef();
-				break;
-			default:
-				// Pass address of c directly - scheduler_thread_create will copy it
-				scheduler_thread_create(main, &c, sizeof(c));
-				break;
+			if (buff_putc(uart_input_buffer, (char)(data & 0xFF))) {
+				rx_dropped++;
 			}
-
-			buff_putc(uart_rx_buffer, c);
 		}
+		schedule_work(&uart_input_work);
+	}
+	if (uart->MIS & PL011_INT_TX) {
+		uart->IMSC &= ~PL011_INT_TXIM;
+		poll_notify();
 	}
 	uart->ICR = PL011_INT_RX | PL011_INT_RT | PL011_INT_OE;
 }
+
+/* Runs on mailbox 0, raised by uart_fiq_handler after it drained the FIFO */
+static void uart_fiq_input_handler(void *ctx)
+{
+	(void)ctx;
+	schedule_work(&uart_input_work);
+}
+
+static void uart_input_work_func(struct work *work)
+{
+	(void)work;
+	while (!buff_is_empty(uart_input_buffer)) {
+		uart_rx_char(buff_getc(uart_input_buffer));
+	}
+	wake_up(&uart_rx_wait);
+	poll_notify();
+}
+
 bool uart_tx_ready(void)
 {
 	return !(uart->FR & PL011_FR_TXFF);
 }
 
+void uart_tx_notify_enable(void)
+{
+	// With RX on the FIQ, the FIQ handler would see the TX interrupt, poll re-checks instead
+	if (!UART_RX_FIQ) {
+		uart->IMSC |= PL011_INT_TXIM;
+	}
+}
+
 bool uart_rx_ready(void)
 {
 	return !(uart->FR & PL011_FR_RXFE);
@@ -0,0 +1,63 @@
+#include <config.h>
+#include <arch/cpu/generic_timer.h>
+#include <arch/bsp/irq_controller.h>
+#include <kernel/kconfig.h>
+#include <kernel/tick.h>
+
+static uint64_t interval	  = 0;
+static uint32_t counts_per_ms	  = 0;
+static uint32_t irq_latency_max = 0; // in counts
+
+static void generic_timer_irq_handler(void *ctx)
+{
+	(void)ctx;
+
+	uint64_t now	 = generic_timer_count();
+	uint64_t cval	 = generic_timer_get_cval();
+	uint32_t latency = (uint32_t)(now - cval);
+	if (latency > irq_latency_max) {
+		irq_latency_max = latency;
+	}
+
+	// Absolute re-arm like the systimer tick, skipping passed ticks
+	cval += interval;
+	while (cval <= now) {
+		cval += interval;
+	}
+	generic_timer_set_cval(cval);
+
+	tick_handle_periodic();
+}
+
+void generic_timer_init(void)
+{
+	counts_per_ms = generic_timer_freq() / 1000;
+
+	if (!TICK_GENERIC_TIMER) {
+		return;
+	}
+
+	// TIMER_INTERVAL is in µs, split it to stay clear of 64 bit division
+	interval = (uint64_t)(TIMER_INTERVAL / 1000) * counts_per_ms +
+		   (TIMER_INTERVAL % 1000) * counts_per_ms / 1000;
+
+	request_irq(IRQ_LOCAL_CNTV, generic_timer_irq_handler, nullptr);
+	generic_timer_set_cval(generic_timer_count() + interval);
+	generic_timer_set_ctl(CNTV_CTL_ENABLE);
+}
+
+uint32_t generic_timer_counts_per_us_q10(void)
+{
+	return (counts_per_ms << 10) / 1000;
+}
+
+uint32_t generic_timer_irq_latency_max(void)
+{
+	uint32_t per_us_q10 = generic_timer_counts_per_us_q10();
+	return per_us_q10 ? (irq_latency_max << 10) / per_us_q10 : 0;
+}
+
+void generic_timer_irq_latency_reset(void)
+{
+	irq_latency_max = 0;
+}
@@ -5,16 +5,12 @@
 
 #include <arch/cpu/mode_registers.h>
 #include <arch/bsp/uart.h>
-#include <arch/bsp/systimer.h>
-
-#define PSR_MODE_MASK 0x1F
-#define PSR_USR	      0x10
-#define PSR_FIQ	      0x11
-#define PSR_IRQ	      0x12
-#define PSR_SVC	      0x13
-#define PSR_ABT	      0x17
-#define PSR_UND	      0x1B
-#define PSR_SYS	      0x1F
+#include <arch/bsp/irq_controller.h>
+#include <arch/cpu/psr.h>
+#include <arch/cpu/pmu.h>
+#include <arch/cpu/irq_flags.h>
+#include <kernel/kconfig.h>
+#include <kernel/syscall.h>
 
 static void read_all_spsrs(exc_frame_t *frame, unsigned int *irq_spsr, unsigned int *abort_spsr,
 			   unsigned int *undefined_spsr, unsigned int *supervisor_spsr)
@@ -82,40 +78,69 @@ void software_interrupt_c(exc_frame_t *frame)
 	uint32_t mode	      = frame->spsr & 0x1f;
 	bool	 is_user_mode = (mode == 0x10);
 
-	if (is_user_mode) {
-		scheduler_terminate_current_thread();
-		scheduler_context_switch(frame);
-	} else {
-		unsigned int cpsr;
-		asm volatile("mrs %0, cpsr" : "=r"(cpsr));
+	if (IRQSOFF_TRACER) {
+		irqsoff_begin(irqsoff_site());
+	}
 
-		handle_exception(frame, "Supervisor Call", false, false, 0, 0, 0, 0, cpsr);
+	if (is_user_mode && syscall_dispatch(frame)) {
+		scheduler_preempt_point();
+		if (IRQSOFF_TRACER) {
+			irqsoff_end(irqsoff_site());
+		}
+		return;
+	}
 
+	unsigned int cpsr;
+	asm volatile("mrs %0, cpsr" : "=r"(cpsr));
+
+	handle_exception(frame, "Supervisor Call", false, false, 0, 0, 0, 0, cpsr);
+
+	if (is_user_mode) {
+		scheduler_exit();
+	} else {
 		uart_putc('\4');
 		while (true) {
 		}
 	}
 }
 
+static exc_frame_t *irq_frame	     = nullptr;
+static uint32_t	    irq_entry_cycles = 0;
+
+exc_frame_t *irq_get_frame(void)
+{
+	return irq_frame;
+}
+
+uint32_t irq_get_entry_cycles(void)
+{
+	return irq_entry_cycles;
+}
+
 void irq_c(exc_frame_t *frame)
 {
-	uint32_t pending1 = gpu_interrupt->IRQPending1;
-	uint32_t pending2 = gpu_interrupt->IRQPending2;
+	irq_entry_cycles = pmu_cycles();
+	if (IRQSOFF_TRACER) {
+		irqsoff_begin(irqsoff_site());
+	}
 
 	unsigned int cpsr;
 	asm volatile("mrs %0, cpsr" : "=r"(cpsr));
 
-	if (pending2 & UART_IRQ_BIT) {
-		uart_irq_handler();
-	}
-	if (pending1 & SYSTIMER_IRQ_BIT) {
-		systimer_handle_irq();
-		scheduler_context_switch(frame);
-	}
+	irq_frame = frame;
+	irq_controller_dispatch();
+	irq_frame = nullptr;
 
 	if (irq_debug) {
 		handle_exception(frame, "IRQ", false, false, 0, 0, 0, 0, cpsr);
 	}
+
+	scheduler_preempt_point();
+
+	// The interrupted context had IRQs enabled, the exception return ends the window
+	if (IRQSOFF_TRACER) {
+		irqsoff_end(irqsoff_site());
+	}
 }
 
 void fiq_c(exc_frame_t *frame)
@@ -126,8 +151,7 @@ void fiq_c(exc_frame_t *frame)
 	uint32_t mode	      = frame->spsr & 0x1f;
 	bool	 is_user_mode = (mode == 0x10);
 	if (is_user_mode) {
-		scheduler_terminate_current_thread();
-		scheduler_context_switch(frame);
+		scheduler_exit();
 	} else {
 		uart_putc('\4');
 		while (true) {
@@ -144,8 +168,7 @@ void undefined_instruction_c(exc_frame_t *frame)
 	uint32_t mode	      = frame->spsr & 0x1f;
 	bool	 is_user_mode = (mode == 0x10);
 	if (is_user_mode) {
-		scheduler_terminate_current_thread();
-		scheduler_context_switch(frame);
+		scheduler_exit();
 	} else {
 		uart_putc('\4');
 		while (true) {
@@ -165,8 +188,7 @@ void prefetch_abort_c(exc_frame_t *frame)
 	uint32_t mode	      = frame->spsr & 0x1f;
 	bool	 is_user_mode = (mode == 0x10);
 	if (is_user_mode) {
-		scheduler_terminate_current_thread();
-		scheduler_context_switch(frame);
+		scheduler_exit();
 	} else {
 		uart_putc('\4');
 		while (true) {
@@ -187,8 +209,7 @@ void data_abort_c(exc_frame_t *frame)
 	bool	 is_user_mode = (mode == 0x10);
 
 	if (is_user_mode) {
-		scheduler_terminate_current_thread();
-		scheduler_context_switch(frame);
+		scheduler_exit();
 	} else {
 		uart_putc('\4');
 		while (true) {
@@ -206,8 +227,7 @@ void not_used_c(exc_frame_t *frame)
 	uint32_t mode	      = frame->spsr & 0x1f;
 	bool	 is_user_mode = (mode == 0x10);
 	if (is_user_mode) {
-		scheduler_terminate_current_thread();
-		scheduler_context_switch(frame);
+		scheduler_exit();
 	} else {
 		uart_putc('\4');
 		while (true) {
@@ -0,0 +1,167 @@
+#include <arch/cpu/sched_fair.h>
+#include <arch/cpu/scheduler.h>
+#include <arch/bsp/systimer.h>
+#include <kernel/kconfig.h>
+
+static tcb_t   *heap[MAX_THREADS];
+static int	heap_size    = 0;
+static uint64_t min_vruntime = 0;
+
+static uint64_t vruntime(int index)
+{
+	return heap[index]->fair.vruntime;
+}
+
+static void heap_set(int index, tcb_t *thread)
+{
+	heap[index]		     = thread;
+	thread->fair.heap_index = index;
+}
+
+static void sift_up(int index)
+{
+	tcb_t *thread = heap[index];
+
+	while (index > 0) {
+		int parent = (index - 1) / 2;
+		if (vruntime(parent) <= thread->fair.vruntime) {
+			break;
+		}
+		heap_set(index, heap[parent]);
+		index = parent;
+	}
+	heap_set(index, thread);
+}
+
+static void sift_down(int index)
+{
+	tcb_t *thread = heap[index];
+
+	while (true) {
+		int child = 2 * index + 1;
+		if (child >= heap_size) {
+			break;
+		}
+		if (child + 1 < heap_size && vruntime(child + 1) < vruntime(child)) {
+			child++;
+		}
+		if (thread->fair.vruntime <= vruntime(child)) {
+			break;
+		}
+		heap_set(index, heap[child]);
+		index = child;
+	}
+	heap_set(index, thread);
+}
+
+static void update_min_vruntime(const tcb_t *current)
+{
+	uint64_t min = current->fair.vruntime;
+
+	if (heap_size && vruntime(0) < min) {
+		min = vruntime(0);
+	}
+	if (min > min_vruntime) {
+		min_vruntime = min;
+	}
+}
+
+void sched_fair_init_thread(tcb_t *thread)
+{
+	thread->fair.vruntime	= min_vruntime;
+	thread->fair.heap_index = -1;
+	sched_fair_set_weight(thread, SCHED_FAIR_WEIGHT_DEFAULT);
+}
+
+void sched_fair_set_weight(tcb_t *thread, uint32_t weight)
+{
+	if (!weight) {
+		weight = 1;
+	}
+	thread->fair.weight = weight;
+	// ceil(2^32 / weight) without 64 bit division, exact for powers of two
+	thread->fair.inv_weight = weight > 1 ? 0xFFFFFFFFu / weight + 1 : 0xFFFFFFFFu;
+}
+
+void sched_fair_enqueue(tcb_t *thread, bool wakeup)
+{
+	if (thread->fair.heap_index >= 0) {
+		return;
+	}
+
+	if (wakeup) {
+		uint64_t floor = min_vruntime > SCHED_FAIR_SLEEPER_CREDIT ?
+					 min_vruntime - SCHED_FAIR_SLEEPER_CREDIT :
+					 0;
+		if (thread->fair.vruntime < floor) {
+			thread->fair.vruntime = floor;
+		}
+	}
+
+	heap_set(heap_size, thread);
+	heap_size++;
+	sift_up(thread->fair.heap_index);
+}
+
+void sched_fair_dequeue(tcb_t *thread)
+{
+	int index = thread->fair.heap_index;
+	if (index < 0) {
+		return;
+	}
+
+	thread->fair.heap_index = -1;
+	heap_size--;
+	if (index == heap_size) {
+		return;
+	}
+
+	tcb_t *last = heap[heap_size];
+	heap_set(index, last);
+	sift_up(index);
+	sift_down(last->fair.heap_index);
+}
+
+tcb_t *sched_fair_pick_next(void)
+{
+	if (!heap_size) {
+		return nullptr;
+	}
+
+	tcb_t *next = heap[0];
+	sched_fair_dequeue(next);
+	return next;
+}
+
+bool sched_fair_tick(tcb_t *current)
+{
+	(void)current;
+	return true;
+}
+
+void sched_fair_yield(tcb_t *current)
+{
+	if (heap_size && current->fair.vruntime <= vruntime(0)) {
+		current->fair.vruntime = vruntime(0) + 1;
+	}
+}
+
+static uint64_t scaled(const tcb_t *thread, uint32_t delta_us)
+{
+	// delta * 1024 / weight as delta * (2^32 / weight) >> 22
+	return ((uint64_t)delta_us * thread->fair.inv_weight) >> 22;
+}
+
+void sched_fair_charge(tcb_t *thread, uint32_t delta_us)
+{
+	thread->fair.vruntime += scaled(thread, delta_us);
+	update_min_vruntime(thread);
+}
+
+bool sched_fair_wakeup_preempt(tcb_t *current, tcb_t *woken)
+{
+	// current is only charged when it is switched out
+	uint32_t ran  = systimer_now() - current->exec_start;
+	uint64_t curr = current->fair.vruntime + scaled(current, ran);
+	return woken->fair.vruntime + SCHED_FAIR_WAKEUP_GRANULARITY < curr;
+}
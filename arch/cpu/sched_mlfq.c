@@ -0,0 +1,139 @@
+#include <arch/cpu/sched_mlfq.h>
+#include <arch/cpu/scheduler.h>
+#include <kernel/hrtimer.h>
+#include <kernel/kconfig.h>
+
+static list_node      levels[MLFQ_LEVELS];
+static uint32_t	      boost_gen = 0;
+static struct hrtimer slice_timer;
+static struct hrtimer boost_timer;
+
+static void slice_expired(struct hrtimer *timer)
+{
+	(void)timer;
+	scheduler_need_resched();
+}
+
+static void boost(struct hrtimer *timer)
+{
+	(void)timer;
+
+	// Queued threads move now, running and blocked ones on their next update
+	boost_gen++;
+	for (unsigned int level = 1; level < MLFQ_LEVELS; level++) {
+		while (!list_is_empty(&levels[level])) {
+			list_node *node	  = list_remove_first(&levels[level]);
+			tcb_t	  *thread = list_entry(node, tcb_t, mlfq.node);
+			thread->mlfq.level	= 0;
+			thread->mlfq.slice_left = MLFQ_QUANTUM[0];
+			thread->mlfq.boost_gen	= boost_gen;
+			list_add_last(&levels[0], node);
+		}
+	}
+}
+
+static void set_level(tcb_t *thread, uint32_t level)
+{
+	thread->mlfq.level	= level;
+	thread->mlfq.slice_left = MLFQ_QUANTUM[level];
+}
+
+static void check_boost(tcb_t *thread)
+{
+	if (thread->mlfq.boost_gen != boost_gen) {
+		thread->mlfq.boost_gen = boost_gen;
+		set_level(thread, 0);
+	}
+}
+
+void sched_mlfq_init(void)
+{
+	for (unsigned int level = 0; level < MLFQ_LEVELS; level++) {
+		list_init(&levels[level]);
+	}
+
+	slice_timer.func = slice_expired;
+	boost_timer.func = boost;
+	hrtimer_start(&boost_timer, MLFQ_BOOST_PERIOD, MLFQ_BOOST_PERIOD);
+}
+
+void sched_mlfq_init_thread(tcb_t *thread)
+{
+	thread->mlfq.queued    = false;
+	thread->mlfq.boost_gen = boost_gen;
+	set_level(thread, 0);
+}
+
+void sched_mlfq_enqueue(tcb_t *thread, bool wakeup)
+{
+	if (thread->mlfq.queued) {
+		return;
+	}
+
+	check_boost(thread);
+	if (wakeup) {
+		set_level(thread, thread->mlfq.level ? thread->mlfq.level - 1 : 0);
+	}
+
+	list_add_last(&levels[thread->mlfq.level], &thread->mlfq.node);
+	thread->mlfq.queued = true;
+}
+
+void sched_mlfq_dequeue(tcb_t *thread)
+{
+	if (!thread->mlfq.queued) {
+		return;
+	}
+
+	list_remove(&levels[thread->mlfq.level], &thread->mlfq.node);
+	thread->mlfq.queued = false;
+}
+
+tcb_t *sched_mlfq_pick_next(void)
+{
+	for (unsigned int level = 0; level < MLFQ_LEVELS; level++) {
+		list_node *node = list_remove_first(&levels[level]);
+		if (node) {
+			tcb_t *thread	    = list_entry(node, tcb_t, mlfq.node);
+			thread->mlfq.queued = false;
+			return thread;
+		}
+	}
+	return nullptr;
+}
+
+void sched_mlfq_charge(tcb_t *thread, uint32_t delta_us)
+{
+	check_boost(thread);
+
+	if (delta_us < thread->mlfq.slice_left) {
+		thread->mlfq.slice_left -= delta_us;
+	} else if (thread->mlfq.level + 1 < MLFQ_LEVELS) {
+		set_level(thread, thread->mlfq.level + 1);
+	} else {
+		set_level(thread, thread->mlfq.level);
+	}
+}
+
+bool sched_mlfq_tick(tcb_t *current)
+{
+	(void)current;
+	return false;
+}
+
+bool sched_mlfq_wakeup_preempt(tcb_t *current, tcb_t *woken)
+{
+	// A boost since current was switched in already put it on level 0
+	uint32_t level = current->mlfq.boost_gen == boost_gen ? current->mlfq.level : 0;
+	return woken->mlfq.level < level;
+}
+
+void sched_mlfq_start_slice(tcb_t *next)
+{
+	if (next) {
+		check_boost(next);
+		hrtimer_start(&slice_timer, next->mlfq.slice_left, 0);
+	} else {
+		hrtimer_cancel(&slice_timer);
+	}
+}
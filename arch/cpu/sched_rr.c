@@ -0,0 +1,45 @@
+#include <arch/cpu/sched_policy.h>
+#include <arch/cpu/scheduler.h>
+
+static_assert(MAX_THREADS <= 32, "ready threads are kept in one 32 bit mask");
+
+static uint32_t ready_mask  = 0;
+static uint32_t last_picked = 0;
+
+void sched_rr_init(void)
+{
+	ready_mask  = 0;
+	last_picked = 0;
+}
+
+void sched_rr_enqueue(tcb_t *thread, bool wakeup)
+{
+	(void)wakeup;
+	ready_mask |= 1u << thread->thread_id;
+}
+
+void sched_rr_dequeue(tcb_t *thread)
+{
+	ready_mask &= ~(1u << thread->thread_id);
+}
+
+bool sched_rr_tick(tcb_t *current)
+{
+	(void)current;
+	return true;
+}
+
+/* Lowest ready id above the last pick, wrapping around like a table scan */
+tcb_t *sched_rr_pick_next(void)
+{
+	if (!ready_mask) {
+		return nullptr;
+	}
+
+	uint32_t above = last_picked < 31 ? ready_mask & (~0u << (last_picked + 1)) : 0;
+	uint32_t id    = __builtin_ctz(above ? above : ready_mask);
+
+	ready_mask &= ~(1u << id);
+	last_picked = id;
+	return scheduler_get_thread((int)id);
+}
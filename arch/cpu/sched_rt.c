@@ -0,0 +1,241 @@
+#include <stddef.h>
+#include <arch/cpu/sched_rt.h>
+#include <arch/cpu/scheduler.h>
+#include <arch/cpu/irq_flags.h>
+#include <arch/bsp/systimer.h>
+#include <kernel/kconfig.h>
+#include <lib/kprintf.h>
+
+static list_node      rt_threads = { &rt_threads, &rt_threads };
+static list_node      pi_threads = { &pi_threads, &pi_threads }; // boosted, not RT
+static uint32_t	      rt_util_permille = 0;
+static struct hrtimer budget_timer;
+
+static bool time_before(uint32_t a, uint32_t b)
+{
+	return (int32_t)(a - b) < 0;
+}
+
+static uint32_t density_permille(uint32_t runtime, uint32_t deadline)
+{
+	return runtime * 1000 / deadline;
+}
+
+static void rt_release(struct hrtimer *timer)
+{
+	struct sched_rt *rt	 = list_entry(timer, struct sched_rt, release_timer);
+	tcb_t		*thread	 = list_entry(rt, tcb_t, rt);
+	uint32_t	 release = timer->expires - rt->period;
+
+	// An unfinished job missed its deadline and continues as the next one
+	if (!rt->job_done) {
+		rt->missed++;
+	}
+
+	rt->jobs++;
+	rt->job_done	 = false;
+	rt->throttled	 = false;
+	rt->budget_left	 = rt->runtime;
+	rt->abs_deadline = release + rt->deadline;
+
+	if (rt->waiting) {
+		rt->waiting = false;
+		scheduler_wake(thread);
+	}
+	// The new deadline may be earlier than the one of the running thread
+	scheduler_need_resched();
+}
+
+static void rt_budget_expired(struct hrtimer *timer)
+{
+	(void)timer;
+	tcb_t *current = scheduler_get_current_thread();
+
+	if (current->rt.active) {
+		current->rt.budget_left = 0;
+		current->rt.throttled	= true;
+		scheduler_need_resched();
+	}
+}
+
+int sched_rt_set(tcb_t *thread, uint32_t runtime, uint32_t period, uint32_t deadline)
+{
+	if (!deadline) {
+		deadline = period;
+	}
+	// runtime * 1000 has to fit into 32 bit
+	if (!runtime || runtime > deadline || deadline > period || runtime > 4000000) {
+		return -1;
+	}
+
+	uint32_t flags = local_irq_save();
+
+	uint32_t util = rt_util_permille + density_permille(runtime, deadline);
+	if (thread->rt.active) {
+		util -= density_permille(thread->rt.runtime, thread->rt.deadline);
+	}
+	if (util > RT_UTIL_MAX_PERMILLE) {
+		local_irq_restore(flags);
+		return -1;
+	}
+	rt_util_permille = util;
+
+	struct sched_rt *rt = &thread->rt;
+	if (!rt->active) {
+		if (rt->pi_active) {
+			list_remove(&pi_threads, &rt->pi_node);
+		}
+		list_add_last(&rt_threads, &rt->node);
+	}
+	rt->runtime	  = runtime;
+	rt->period	  = period;
+	rt->deadline	  = deadline;
+	rt->active	  = true;
+	rt->job_done	  = true;
+	rt->waiting	  = false;
+	rt->jobs	  = 0;
+	rt->missed	  = 0;
+	rt->release_timer.func = rt_release;
+	budget_timer.func      = rt_budget_expired;
+
+	hrtimer_start(&rt->release_timer, 0, period);
+
+	local_irq_restore(flags);
+	return 0;
+}
+
+void sched_rt_clear(tcb_t *thread)
+{
+	uint32_t	 flags = local_irq_save();
+	struct sched_rt *rt    = &thread->rt;
+
+	if (rt->active) {
+		hrtimer_cancel(&rt->release_timer);
+		list_remove(&rt_threads, &rt->node);
+		rt_util_permille -= density_permille(rt->runtime, rt->deadline);
+		rt->active = false;
+		if (rt->pi_active) {
+			list_add_last(&pi_threads, &rt->pi_node);
+		}
+	}
+
+	local_irq_restore(flags);
+}
+
+bool sched_rt_deadline(const tcb_t *thread, uint32_t *deadline)
+{
+	const struct sched_rt *rt = &thread->rt;
+
+	if (rt->active && !rt->throttled) {
+		*deadline = rt->pi_active && time_before(rt->pi_deadline, rt->abs_deadline) ?
+				    rt->pi_deadline :
+				    rt->abs_deadline;
+		return true;
+	}
+	if (rt->pi_active) {
+		*deadline = rt->pi_deadline;
+		return true;
+	}
+	return false;
+}
+
+static void pick_from(list_node *head, size_t node_offset, tcb_t **best, uint32_t *best_deadline)
+{
+	for (list_node *curr = head->next; curr != head; curr = curr->next) {
+		tcb_t	*thread = (tcb_t *)((char *)curr - node_offset);
+		uint32_t deadline;
+
+		if (thread->state != THREAD_STATE_READY && thread->state != THREAD_STATE_RUNNING) {
+			continue;
+		}
+		if (!sched_rt_deadline(thread, &deadline)) {
+			continue;
+		}
+		if (!*best || time_before(deadline, *best_deadline)) {
+			*best	       = thread;
+			*best_deadline = deadline;
+		}
+	}
+}
+
+tcb_t *sched_rt_pick_next(void)
+{
+	tcb_t	*best	       = nullptr;
+	uint32_t best_deadline = 0;
+
+	pick_from(&rt_threads, offsetof(tcb_t, rt.node), &best, &best_deadline);
+	pick_from(&pi_threads, offsetof(tcb_t, rt.pi_node), &best, &best_deadline);
+
+	return best;
+}
+
+void sched_rt_pi_set(tcb_t *thread, uint32_t deadline)
+{
+	struct sched_rt *rt = &thread->rt;
+
+	if (!rt->pi_active && !rt->active) {
+		list_add_last(&pi_threads, &rt->pi_node);
+	}
+	rt->pi_deadline = deadline;
+	rt->pi_active	= true;
+}
+
+void sched_rt_pi_clear(tcb_t *thread)
+{
+	struct sched_rt *rt = &thread->rt;
+
+	if (rt->pi_active && !rt->active) {
+		list_remove(&pi_threads, &rt->pi_node);
+	}
+	rt->pi_active = false;
+}
+
+void sched_rt_switch(tcb_t *prev, tcb_t *next)
+{
+	uint32_t now = systimer_now();
+
+	if (prev->rt.active && !prev->rt.throttled) {
+		uint32_t used = now - prev->rt.exec_start;
+		prev->rt.budget_left -= used < prev->rt.budget_left ? used : prev->rt.budget_left;
+	}
+
+	// A throttled thread only runs on an inherited deadline, without budget
+	if (next->rt.active && !next->rt.throttled) {
+		next->rt.exec_start = now;
+		hrtimer_start(&budget_timer, next->rt.budget_left, 0);
+	} else {
+		hrtimer_cancel(&budget_timer);
+	}
+}
+
+void sched_rt_wait_period(void)
+{
+	tcb_t *current = scheduler_get_current_thread();
+	if (!current->rt.active) {
+		return;
+	}
+
+	uint32_t flags = local_irq_save();
+
+	if (time_before(current->rt.abs_deadline, systimer_now())) {
+		current->rt.missed++;
+	}
+	current->rt.job_done = true;
+	current->rt.waiting  = true;
+	while (current->rt.waiting) {
+		scheduler_block_current();
+	}
+
+	local_irq_restore(flags);
+}
+
+void sched_rt_print_stats(void)
+{
+	kprintf("rt: utilization %u permille\n", rt_util_permille);
+	for (list_node *curr = rt_threads.next; curr != &rt_threads; curr = curr->next) {
+		tcb_t *thread = list_entry(curr, tcb_t, rt.node);
+		kprintf("%2u: %u/%u/%u us, %u jobs, %u missed\n", thread->thread_id,
+			thread->rt.runtime, thread->rt.deadline, thread->rt.period, thread->rt.jobs,
+			thread->rt.missed);
+	}
+}
@@ -1,46 +1,256 @@
 #include "arch/cpu/scheduler.h"
 #include <arch/bsp/uart.h>
+#include <arch/bsp/systimer.h>
 #include <arch/cpu/interrupts.h>
+#include <arch/cpu/irq_flags.h>
+#include <arch/cpu/pmu.h>
+#include <arch/cpu/psr.h>
+#include <kernel/futex.h>
+#include <kernel/kconfig.h>
+#include <kernel/uring.h>
+#include <kernel/wait.h>
 #include <lib/kprintf.h>
 #include <lib/mem.h>
+#include <user/thread.h>
+
+static tcb_t	     thread_table[MAX_THREADS];
+static uint32_t	     current_thread_id = 0;
+static bool	     scheduler_running = false;
+static bool	     need_resched      = false;
+static uint32_t	     last_user_thread  = IDLE_THREAD_ID;
+static uint32_t	     jiffies	       = 0;
+static cpu_context_t boot_context;
+static wait_queue_t  sleep_queue = WAIT_QUEUE_INIT(sleep_queue);
+
+static uint32_t context_switches  = 0;
+static uint32_t pick_count	  = 0;
+static uint32_t pick_cycles_max	  = 0;
+static uint64_t pick_cycles_total = 0;
+
+/*
+ * Dispatch to the policy selected by SCHED_POLICY, see sched_policy.h.
+ * The switches are on a constant, every call is direct even at -O0.
+ */
+static const char *policy_name(void)
+{
+	switch (SCHED_POLICY) {
+	case SCHED_POLICY_FAIR:
+		return "fair";
+	case SCHED_POLICY_MLFQ:
+		return "mlfq";
+	default:
+		return "round robin";
+	}
+}
+
+static void policy_init(void)
+{
+	switch (SCHED_POLICY) {
+	case SCHED_POLICY_FAIR:
+		break;
+	case SCHED_POLICY_MLFQ:
+		sched_mlfq_init();
+		break;
+	default:
+		sched_rr_init();
+		break;
+	}
+}
+
+static void policy_init_thread(tcb_t *thread)
+{
+	switch (SCHED_POLICY) {
+	case SCHED_POLICY_FAIR:
+		sched_fair_init_thread(thread);
+		break;
+	case SCHED_POLICY_MLFQ:
+		sched_mlfq_init_thread(thread);
+		break;
+	default:
+		break;
+	}
+}
+
+static void policy_enqueue(tcb_t *thread, bool wakeup)
+{
+	switch (SCHED_POLICY) {
+	case SCHED_POLICY_FAIR:
+		sched_fair_enqueue(thread, wakeup);
+		break;
+	case SCHED_POLICY_MLFQ:
+		sched_mlfq_enqueue(thread, wakeup);
+		break;
+	default:
+		sched_rr_enqueue(thread, wakeup);
+		break;
+	}
+}
+
+static void policy_dequeue(tcb_t *thread)
+{
+	switch (SCHED_POLICY) {
+	case SCHED_POLICY_FAIR:
+		sched_fair_dequeue(thread);
+		break;
+	case SCHED_POLICY_MLFQ:
+		sched_mlfq_dequeue(thread);
+		break;
+	default:
+		sched_rr_dequeue(thread);
+		break;
+	}
+}
+
+static tcb_t *policy_pick_next(void)
+{
+	switch (SCHED_POLICY) {
+	case SCHED_POLICY_FAIR:
+		return sched_fair_pick_next();
+	case SCHED_POLICY_MLFQ:
+		return sched_mlfq_pick_next();
+	default:
+		return sched_rr_pick_next();
+	}
+}
+
+static void policy_charge(tcb_t *thread, uint32_t delta_us)
+{
+	switch (SCHED_POLICY) {
+	case SCHED_POLICY_FAIR:
+		sched_fair_charge(thread, delta_us);
+		break;
+	case SCHED_POLICY_MLFQ:
+		sched_mlfq_charge(thread, delta_us);
+		break;
+	default:
+		break;
+	}
+}
 
-static tcb_t	thread_table[MAX_THREADS];
-static uint32_t current_thread_id = 0;
-static bool	scheduler_running = false;
+static bool policy_tick(tcb_t *current)
+{
+	switch (SCHED_POLICY) {
+	case SCHED_POLICY_FAIR:
+		return sched_fair_tick(current);
+	case SCHED_POLICY_MLFQ:
+		return sched_mlfq_tick(current);
+	default:
+		return sched_rr_tick(current);
+	}
+}
+
+static void policy_yield(tcb_t *current)
+{
+	switch (SCHED_POLICY) {
+	case SCHED_POLICY_FAIR:
+		sched_fair_yield(current);
+		break;
+	default:
+		break;
+	}
+}
+
+static void policy_switch_in(tcb_t *next)
+{
+	switch (SCHED_POLICY) {
+	case SCHED_POLICY_MLFQ:
+		sched_mlfq_start_slice(next);
+		break;
+	default:
+		break;
+	}
+}
+
+static bool policy_wakeup_preempt(tcb_t *current, tcb_t *woken)
+{
+	switch (SCHED_POLICY) {
+	case SCHED_POLICY_FAIR:
+		return sched_fair_wakeup_preempt(current, woken);
+	case SCHED_POLICY_MLFQ:
+		return sched_mlfq_wakeup_preempt(current, woken);
+	default:
+		return false;
+	}
+}
 
 static void idle_thread(void *arg)
 {
 	(void)arg;
 	while (1) {
+		asm volatile("wfi");
 	}
 }
 
-void syscall_exit(void)
+static void kthread_exit(void)
 {
-	__asm volatile("svc #0");
-	while (1)
-		;
+	scheduler_exit();
 }
 
-static void thread_wrapper(void)
+/*
+ * Builds the initial frame at the top of the kernel stack. The first
+ * cpu_switch_to to the thread continues in exc_return, which "returns"
+ * from that frame into func.
+ */
+static void thread_setup(tcb_t *thread, uint32_t pc, uint32_t spsr, uint32_t r0, uint32_t r1,
+			 uint32_t usr_sp)
 {
-	uint32_t func_ptr, arg_ptr;
-
-	__asm volatile("mov %0, r0\n"
-		       "mov %1, r1\n"
-		       : "=r"(func_ptr), "=r"(arg_ptr)
-		       :
-		       : "r0", "r1");
+	uint32_t kstack_top = (uint32_t)&thread->kstack[KERNEL_STACK_SIZE];
+	kstack_top &= ~0x7;
+
+	exc_frame_t *frame = (exc_frame_t *)(kstack_top - sizeof(exc_frame_t));
+	memset(frame, 0, sizeof(exc_frame_t));
+
+	frame->r0     = r0;
+	frame->r1     = r1;
+	frame->sp     = usr_sp;
+	frame->svc_lr = (uint32_t)kthread_exit;
+	frame->lr     = pc;
+	frame->spsr   = spsr;
+
+	memset(&thread->context, 0, sizeof(cpu_context_t));
+	thread->context.r4 = (uint32_t)frame;
+	thread->context.sp = (uint32_t)frame;
+	thread->context.lr = (uint32_t)exc_return;
+
+	thread->frame	      = frame;
+	thread->preempt_count = 0;
+	thread->urgent	      = false;
+	thread->exit_hook     = nullptr;
+	thread->rt.active     = false;
+	thread->rt.pi_active  = false;
+	thread->futex_addr    = nullptr;
+	ipc_thread_init(thread);
+	thread->exec_total    = 0;
+	policy_init_thread(thread);
+}
 
-	void (*func)(void *) = (void (*)(void *))func_ptr;
-	void *arg	     = (void *)arg_ptr;
+/* Threads that are scheduled by SCHED_POLICY, not by the RT class or as urgent */
+static bool is_normal(const tcb_t *thread)
+{
+	return thread->thread_id != IDLE_THREAD_ID && !thread->urgent && !thread->rt.active &&
+	       !thread->rt.pi_active;
+}
 
-	if (arg) {
+static void normal_enqueue(tcb_t *thread, bool wakeup)
+{
+	if (is_normal(thread)) {
+		policy_enqueue(thread, wakeup);
 	}
+}
 
-	func(arg);
+static bool is_user_thread(const tcb_t *thread)
+{
+	return (thread->frame->spsr & PSR_MODE_MASK) == PSR_USR;
+}
 
-	syscall_exit();
+static int find_free_slot(void)
+{
+	for (int i = 1; i < MAX_THREADS; i++) {
+		if (thread_table[i].state == THREAD_STATE_TERMINATED) {
+			return i;
+		}
+	}
+	return -1;
 }
 
 void scheduler_init(void)
@@ -50,48 +260,33 @@ void scheduler_init(void)
 		thread_table[i].thread_id = i;
 	}
 
-	current_thread_id     = 0;
-	thread_table[0].state = THREAD_STATE_RUNNING;
-
-	memset(&thread_table[0].context, 0, sizeof(thread_context_t));
+	policy_init();
 
-	uint32_t stack_top = (uint32_t)&thread_table[0].stack[THREAD_STACK_SIZE];
-	stack_top &= ~0x7;
-
-	thread_table[0].context.sp   = stack_top;
-	thread_table[0].context.lr   = (uint32_t)idle_thread;
-	thread_table[0].context.cpsr = 0x10;
+	current_thread_id = IDLE_THREAD_ID;
+	thread_setup(&thread_table[IDLE_THREAD_ID], (uint32_t)idle_thread, PSR_SVC, 0, 0, 0);
+	thread_table[IDLE_THREAD_ID].state = THREAD_STATE_RUNNING;
 
 	scheduler_running = false;
 }
 
 void scheduler_start [[noreturn]] (void)
 {
+	local_irq_disable();
 	scheduler_running = true;
-	while (1) {
-	}
+	cpu_switch_to(&boot_context, &thread_table[IDLE_THREAD_ID].context);
 
 	__builtin_unreachable();
 }
 
-void scheduler_thread_create(void (*func)(void *), const void *arg, unsigned int arg_size)
+int scheduler_thread_create(void (*func)(void *), const void *arg, unsigned int arg_size)
 {
-	uint32_t cpsr;
-	__asm volatile("mrs %0, cpsr" : "=r"(cpsr));
-	__asm volatile("cpsid if");
-
-	int free_slot = -1;
-	for (int i = 1; i < MAX_THREADS; i++) {
-		if (thread_table[i].state == THREAD_STATE_TERMINATED) {
-			free_slot = i;
-			break;
-		}
-	}
+	uint32_t flags = local_irq_save();
 
+	int free_slot = find_free_slot();
 	if (free_slot == -1) {
 		uart_puts("Could not create thread.\n");
-		__asm volatile("msr cpsr_c, %0" : : "r"(cpsr));
-		return;
+		local_irq_restore(flags);
+		return -1;
 	}
 
 	tcb_t *new_thread = &thread_table[free_slot];
@@ -107,113 +302,353 @@ void scheduler_thread_create(void (*func)(void *), const void *arg, unsigned int
 		arg_ptr = (void *)stack_top;
 	}
 
-	memset(&new_thread->context, 0, sizeof(thread_context_t));
+	thread_setup(new_thread, (uint32_t)thread_entry, PSR_USR, (uint32_t)func,
+		     (uint32_t)arg_ptr, stack_top);
+
+	new_thread->state     = THREAD_STATE_READY;
+	new_thread->thread_id = free_slot;
+	normal_enqueue(new_thread, false);
+
+	local_irq_restore(flags);
+	return free_slot;
+}
 
-	new_thread->context.r0	 = (uint32_t)func;
-	new_thread->context.r1	 = (uint32_t)arg_ptr;
-	new_thread->context.sp	 = stack_top;
-	new_thread->context.lr	 = (uint32_t)thread_wrapper;
-	new_thread->context.cpsr = 0x10;
+int scheduler_kthread_create(void (*func)(void *), void *arg)
+{
+	uint32_t flags = local_irq_save();
+
+	int free_slot = find_free_slot();
+	if (free_slot == -1) {
+		uart_puts("Could not create kernel thread.\n");
+		local_irq_restore(flags);
+		return -1;
+	}
+
+	tcb_t *new_thread = &thread_table[free_slot];
+	thread_setup(new_thread, (uint32_t)func, PSR_SVC, (uint32_t)arg, 0, 0);
 
 	new_thread->state     = THREAD_STATE_READY;
 	new_thread->thread_id = free_slot;
+	normal_enqueue(new_thread, false);
 
-	__asm volatile("msr cpsr_c, %0" : : "r"(cpsr));
+	local_irq_restore(flags);
+	return free_slot;
 }
 
-void scheduler_schedule(void)
+static uint32_t pick_next(void)
 {
-	if (!scheduler_running) {
-		return;
+	for (uint32_t i = 1; i < MAX_THREADS; i++) {
+		if (thread_table[i].urgent && thread_table[i].state == THREAD_STATE_READY) {
+			return i;
+		}
 	}
 
-	uint32_t old_thread_id = current_thread_id;
+	tcb_t *rt = sched_rt_pick_next();
+	if (rt) {
+		return rt->thread_id;
+	}
+
+	tcb_t *next = policy_pick_next();
+	return next ? next->thread_id : IDLE_THREAD_ID;
+}
+
+/* Accounts the runtime of prev and queues it again if it is still runnable */
+static uint32_t put_prev(tcb_t *prev)
+{
+	need_resched = false;
+
+	uint32_t now   = systimer_now();
+	uint32_t delta = now - prev->exec_start;
+	prev->exec_total += delta;
+	if (is_normal(prev)) {
+		policy_charge(prev, delta);
+	}
 
-	if (thread_table[current_thread_id].state == THREAD_STATE_RUNNING) {
-		thread_table[current_thread_id].state = THREAD_STATE_READY;
+	if (prev->state == THREAD_STATE_RUNNING) {
+		prev->state = THREAD_STATE_READY;
+		normal_enqueue(prev, false);
 	}
 
-	uint32_t next_id = current_thread_id;
+	return now;
+}
 
-	for (uint32_t count = 0; count < MAX_THREADS - 1; count++) {
-		if (next_id == 0 || next_id >= MAX_THREADS - 1) {
-			next_id = 1;
-		} else {
-			next_id++;
-		}
+static void switch_to(tcb_t *prev, uint32_t next_id, uint32_t now)
+{
+	if (is_user_thread(&thread_table[next_id]) && next_id != last_user_thread) {
+		uart_putc('\n');
+		last_user_thread = next_id;
+	}
 
-		if (thread_table[next_id].state == THREAD_STATE_READY) {
-			current_thread_id		      = next_id;
-			thread_table[current_thread_id].state = THREAD_STATE_RUNNING;
+	tcb_t *next = &thread_table[next_id];
 
-			if (old_thread_id != current_thread_id) {
-				uart_putc('\n');
-			}
-			return;
-		}
+	current_thread_id = next_id;
+	next->state	  = THREAD_STATE_RUNNING;
+	next->exec_start  = now;
+	sched_rt_switch(prev, next);
+	policy_switch_in(is_normal(next) ? next : nullptr);
+
+	if (next_id != prev->thread_id) {
+		context_switches++;
+		// Thread id for user space, e.g. as owner of a futex mutex
+		asm volatile("mcr p15, 0, %0, c13, c0, 3" : : "r"(next_id));
+		cpu_switch_to(&prev->context, &thread_table[next_id].context);
 	}
+}
 
-	current_thread_id		   = IDLE_THREAD_ID;
-	thread_table[IDLE_THREAD_ID].state = THREAD_STATE_RUNNING;
+/*
+ * Switches to the next runnable thread. Must be called with IRQs
+ * disabled, returns once the current thread is scheduled again.
+ */
+static void schedule(void)
+{
+	tcb_t	*prev = &thread_table[current_thread_id];
+	uint32_t now  = put_prev(prev);
+
+	uint32_t start	 = pmu_cycles();
+	uint32_t next_id = pick_next();
+	uint32_t cycles	 = pmu_cycles() - start;
+
+	pick_count++;
+	pick_cycles_total += cycles;
+	if (cycles > pick_cycles_max) {
+		pick_cycles_max = cycles;
+	}
+
+	switch_to(prev, next_id, now);
+}
+
+void scheduler_exit [[noreturn]] (void)
+{
+	tcb_t *current = &thread_table[current_thread_id];
+
+	local_irq_disable();
+	sched_rt_clear(current);
+	scheduler_pi_unboost(current);
+	ipc_thread_exit(current);
+	futex_thread_exit(current);
+	uring_thread_exit(current);
+	if (current->exit_hook) {
+		current->exit_hook(current);
+	}
+	current->state = THREAD_STATE_TERMINATED;
+	schedule();
+
+	__builtin_unreachable();
+}
+
+void scheduler_yield(void)
+{
+	uint32_t flags = local_irq_save();
+
+	tcb_t *current = &thread_table[current_thread_id];
+	if (is_normal(current)) {
+		policy_yield(current);
+	}
+	schedule();
+	local_irq_restore(flags);
 }
 
-void scheduler_terminate_current_thread(void)
+void scheduler_sleep(uint32_t ticks)
 {
-	thread_table[current_thread_id].state = THREAD_STATE_TERMINATED;
+	uint32_t until = jiffies + ticks;
+	wait_event(&sleep_queue, (int32_t)(jiffies - until) >= 0);
 }
 
-void scheduler_context_switch(exc_frame_t *frame)
+uint32_t scheduler_jiffies(void)
+{
+	return jiffies;
+}
+
+void scheduler_tick(void)
+{
+	jiffies++;
+	wake_up(&sleep_queue);
+	if (scheduler_policy_tick()) {
+		need_resched = true;
+	}
+}
+
+/*
+ * Called on the way back from an exception with IRQs disabled.
+ * Preempts the current thread if a reschedule is pending and the
+ * thread is not inside a preempt_disable section.
+ */
+void scheduler_preempt_point(void)
 {
 	if (!scheduler_running) {
 		return;
 	}
 
-	tcb_t	*current       = &thread_table[current_thread_id];
-	uint32_t old_thread_id = current_thread_id;
-
-	scheduler_schedule();
-
-	if (old_thread_id != current_thread_id && current->state != THREAD_STATE_TERMINATED) {
-		current->context.cpsr = frame->spsr;
-		current->context.sp   = frame->sp;
-		current->context.r0   = frame->r0;
-		current->context.r1   = frame->r1;
-		current->context.r2   = frame->r2;
-		current->context.r3   = frame->r3;
-		current->context.r4   = frame->r4;
-		current->context.r5   = frame->r5;
-		current->context.r6   = frame->r6;
-		current->context.r7   = frame->r7;
-		current->context.r8   = frame->r8;
-		current->context.r9   = frame->r9;
-		current->context.r10  = frame->r10;
-		current->context.r11  = frame->r11;
-		current->context.r12  = frame->r12;
-		current->context.lr   = frame->lr;
-	}
-
-	tcb_t *next = &thread_table[current_thread_id];
-
-	if (next->state == THREAD_STATE_TERMINATED) {
-		next		  = &thread_table[0];
-		current_thread_id = 0;
-		next->state	  = THREAD_STATE_RUNNING;
-	}
-
-	frame->spsr = next->context.cpsr;
-	frame->sp   = next->context.sp;
-	frame->r0   = next->context.r0;
-	frame->r1   = next->context.r1;
-	frame->r2   = next->context.r2;
-	frame->r3   = next->context.r3;
-	frame->r4   = next->context.r4;
-	frame->r5   = next->context.r5;
-	frame->r6   = next->context.r6;
-	frame->r7   = next->context.r7;
-	frame->r8   = next->context.r8;
-	frame->r9   = next->context.r9;
-	frame->r10  = next->context.r10;
-	frame->r11  = next->context.r11;
-	frame->r12  = next->context.r12;
-	frame->lr   = next->context.lr;
+	if (need_resched && thread_table[current_thread_id].preempt_count == 0) {
+		schedule();
+	}
+}
+
+void scheduler_block_current(void)
+{
+	thread_table[current_thread_id].state = THREAD_STATE_BLOCKED;
+	schedule();
+}
+
+void scheduler_wake(tcb_t *thread)
+{
+	if (thread->state != THREAD_STATE_BLOCKED) {
+		return;
+	}
+
+	thread->state = THREAD_STATE_READY;
+	normal_enqueue(thread, true);
+	if (thread->urgent || thread->rt.active || current_thread_id == IDLE_THREAD_ID) {
+		need_resched = true;
+		return;
+	}
+
+	tcb_t *current = &thread_table[current_thread_id];
+	if (is_normal(thread) && is_normal(current) && policy_wakeup_preempt(current, thread)) {
+		need_resched = true;
+	}
+}
+
+void scheduler_pi_boost(tcb_t *thread, uint32_t deadline)
+{
+	if (is_normal(thread)) {
+		policy_dequeue(thread);
+	}
+	sched_rt_pi_set(thread, deadline);
+	need_resched = true;
+}
+
+void scheduler_pi_unboost(tcb_t *thread)
+{
+	if (!thread->rt.pi_active) {
+		return;
+	}
+
+	sched_rt_pi_clear(thread);
+	if (thread->state == THREAD_STATE_READY) {
+		normal_enqueue(thread, false);
+	}
+	need_resched = true;
+}
+
+/* Urgent threads rank above the RT class, which ranks above normal threads */
+static unsigned int class_rank(const tcb_t *thread)
+{
+	if (thread->urgent) {
+		return 2;
+	}
+	return thread->rt.active || thread->rt.pi_active ? 1 : 0;
+}
+
+bool scheduler_handoff(tcb_t *next)
+{
+	tcb_t *prev = &thread_table[current_thread_id];
+
+	// A pending reschedule or a lower class receiver has to go through pick_next
+	if (need_resched || class_rank(next) < class_rank(prev)) {
+		scheduler_wake(next);
+		schedule();
+		return false;
+	}
+
+	uint32_t now = put_prev(prev);
+	switch_to(prev, next->thread_id, now);
+	return true;
+}
+
+void scheduler_need_resched(void)
+{
+	need_resched = true;
+}
+
+void scheduler_set_urgent(int tid)
+{
+	if (tid > IDLE_THREAD_ID && tid < MAX_THREADS) {
+		policy_dequeue(&thread_table[tid]);
+		thread_table[tid].urgent = true;
+	}
+}
+
+void scheduler_set_exit_hook(int tid, void (*hook)(tcb_t *thread))
+{
+	if (tid > IDLE_THREAD_ID && tid < MAX_THREADS) {
+		thread_table[tid].exit_hook = hook;
+	}
+}
+
+tcb_t *scheduler_get_current_thread(void)
+{
+	return &thread_table[current_thread_id];
+}
+
+const char *scheduler_policy_name(void)
+{
+	return policy_name();
+}
+
+/* Whether the policy preempts on a tick, for test code that emulates the tick */
+bool scheduler_policy_tick(void)
+{
+	return policy_tick(&thread_table[current_thread_id]);
+}
+
+/* False as well for slots that were never set up */
+bool scheduler_is_user_thread(const tcb_t *thread)
+{
+	return thread->frame && is_user_thread(thread);
+}
+
+tcb_t *scheduler_get_thread(int tid)
+{
+	if (tid < 0 || tid >= MAX_THREADS) {
+		return nullptr;
+	}
+	return &thread_table[tid];
+}
+
+void scheduler_print_stats(void)
+{
+	uint32_t flags	      = local_irq_save();
+	uint32_t count	      = pick_count;
+	uint64_t total	      = pick_cycles_total;
+	uint32_t max	      = pick_cycles_max;
+	uint32_t switch_count = context_switches;
+	local_irq_restore(flags);
+
+	// Scale both down until the division fits into 32 bit
+	uint32_t divisor = count;
+	while (total >> 32) {
+		total >>= 1;
+		divisor >>= 1;
+	}
+	uint32_t avg = divisor ? (uint32_t)total / divisor : 0;
+
+	kprintf("scheduler: %u context switches, pick_next avg %u max %u cycles (%u picks)\n",
+		switch_count, avg, max, count);
+}
+
+void scheduler_reset_stats(void)
+{
+	uint32_t flags	  = local_irq_save();
+	context_switches  = 0;
+	pick_count	  = 0;
+	pick_cycles_max	  = 0;
+	pick_cycles_total = 0;
+	local_irq_restore(flags);
+}
+
+void preempt_disable(void)
+{
+	thread_table[current_thread_id].preempt_count++;
+}
+
+void preempt_enable(void)
+{
+	tcb_t *current = &thread_table[current_thread_id];
+
+	if (--current->preempt_count == 0 && need_resched && scheduler_running) {
+		uint32_t flags = local_irq_save();
+		schedule();
+		local_irq_restore(flags);
+	}
 }
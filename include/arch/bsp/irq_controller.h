@@ -0,0 +1,51 @@
+#ifndef ARCH_BSP_IRQ_CONTROLLER_H
+#define ARCH_BSP_IRQ_CONTROLLER_H
+
+#include <stdint.h>
+
+/*
+ * IRQ numbers of the BCM2835 interrupt controller:
+ * 0-31 GPU IRQs in pending register 1, 32-63 in pending register 2 and
+ * 64-71 the ARM specific IRQs of the basic pending register.
+ * 72-83 are the per core sources of the BCM2836 local controller.
+ */
+#define IRQ_COUNT    84
+#define IRQ_BASIC(n) (64 + (n))
+#define IRQ_LOCAL(n) (72 + (n))
+
+#define IRQ_SYSTIMER_1 1
+#define IRQ_SYSTIMER_3 3
+#define IRQ_UART       57
+
+#define IRQ_LOCAL_CNTPNS   IRQ_LOCAL(1)
+#define IRQ_LOCAL_CNTV	   IRQ_LOCAL(3)
+#define IRQ_LOCAL_MAILBOX0 IRQ_LOCAL(4)
+#define IRQ_LOCAL_MAILBOX1 IRQ_LOCAL(5)
+#define IRQ_LOCAL_PMU	   IRQ_LOCAL(9)
+
+typedef void (*irq_handler_t)(void *ctx);
+
+/* Registers handler for irq and enables it. Returns -1 if irq is taken or invalid. */
+int  request_irq(unsigned int irq, irq_handler_t handler, void *ctx);
+void free_irq(unsigned int irq);
+
+/* Routes one GPU or basic IRQ to the FIQ instead, only one source at a time */
+int  request_fiq(unsigned int irq);
+void free_fiq(void);
+
+/*
+ * Raises a mailbox IRQ on core 0, used as a software triggered IRQ.
+ * The mailbox is cleared before its handler runs.
+ */
+void irq_controller_raise_mailbox(unsigned int mailbox);
+
+/* Services every pending IRQ, called once per IRQ exception */
+void irq_controller_dispatch(void);
+
+/* Longest single dispatch in cycles since the last call, starts over at 0 */
+uint32_t irq_controller_dispatch_max_reset(void);
+
+/* Prints count and cycles spent per IRQ */
+void irq_controller_print_stats(void);
+
+#endif
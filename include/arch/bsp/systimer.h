@@ -4,8 +4,17 @@
 #include <stdint.h>
 #include <stdbool.h>
 
-#define SYSTIMER_IRQ_BIT (1u << 1)
-
 void systimer_init(void);
 bool systimer_handle_irq(void);
+
+/* Free running 1 MHz counter */
+uint32_t systimer_now(void);
+
+/* Worst delay between the programmed compare value and the tick handler in µs */
+uint32_t systimer_irq_latency_max(void);
+void	 systimer_irq_latency_reset(void);
+
+/* Compare channel 3, owned by the hrtimer queue */
+void systimer_c3_arm(uint32_t deadline);
+void systimer_c3_ack(void);
 #endif
@@ -4,12 +4,26 @@
 #include <stdint.h>
 #include <stdbool.h>
 
+struct uart_rx_stats {
+	uint32_t overruns;     // RX FIFO overruns reported by the PL011
+	uint32_t input_drops;  // raw input buffer full when the FIFO was drained
+	uint32_t rx_overflows; // getc buffer full, its reader is behind
+};
+
 void uart_init(void);
-void uart_loopback(void);
+/* Feeds every transmitted character back into the RX FIFO */
+void uart_loopback(bool enable);
 char uart_getc(void);
 void uart_putc(char input);
 void uart_puts(const char *string);
-void uart_irq_handler(void);
+void uart_write(const char *buf, uint32_t len);
+bool uart_data_available(void);
+bool uart_tx_ready(void);
+/* One poll_notify once the TX FIFO has room again, only with RX on the IRQ */
+void uart_tx_notify_enable(void);
+void uart_irq_handler(void *ctx);
+void uart_get_rx_stats(struct uart_rx_stats *stats);
+void uart_print_stats(void);
 
 enum gpio_func {
 	gpio_input  = 0x0,
@@ -27,22 +41,6 @@ struct gpio {
 static const unsigned int	   GPIO_BASE = 0x7E200000 - 0x3F000000;
 static volatile struct gpio *const gpio_port = (struct gpio *)GPIO_BASE;
 
-typedef struct {
-	volatile uint32_t IRQBasicPending;
-	volatile uint32_t IRQPending1;
-	volatile uint32_t IRQPending2;
-	volatile uint32_t FIQControl;
-	volatile uint32_t EnableIRQs1;
-	volatile uint32_t EnableIRQs2;
-	volatile uint32_t EnableBasicIRQs;
-	volatile uint32_t DisableIRQs1;
-	volatile uint32_t DisableIRQs2;
-	volatile uint32_t DisableBasicIRQs;
-} GPU_Interrupt_Controller;
-
-extern volatile GPU_Interrupt_Controller *const gpu_interrupt;
-extern bool					irq_debug;
-
-#define UART_IRQ_BIT (1 << 25)
+extern bool irq_debug;
 
 #endif // UART_H
@@ -0,0 +1,32 @@
+#ifndef ARCH_CPU_FIQ_H
+#define ARCH_CPU_FIQ_H
+
+#include <stdint.h>
+
+/* Banked registers a FIQ handler keeps its state in */
+struct fiq_regs {
+	uint32_t r8;
+	uint32_t r9;
+	uint32_t r10;
+	uint32_t r11;
+	uint32_t r12;
+	uint32_t sp;
+};
+
+/* Loads the banked FIQ registers r8-r12 and sp */
+void fiq_set_regs(const struct fiq_regs *regs);
+
+/* Points the FIQ vector directly at handler, which returns with subs pc, lr, #4 */
+void fiq_set_handler(void (*handler)(void));
+
+static inline void fiq_enable(void)
+{
+	asm volatile("cpsie f" : : : "memory");
+}
+
+static inline void fiq_disable(void)
+{
+	asm volatile("cpsid f" : : : "memory");
+}
+
+#endif
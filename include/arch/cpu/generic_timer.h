@@ -0,0 +1,90 @@
+#ifndef ARCH_CPU_GENERIC_TIMER_H
+#define ARCH_CPU_GENERIC_TIMER_H
+
+#include <stdint.h>
+
+/*
+ * Cortex-A7 generic timer, virtual view (CNTV). The counter is read
+ * through CP15 instead of the peripheral bus, its IRQ reaches the core
+ * through the BCM2836 local interrupt controller.
+ */
+
+#define CNTV_CTL_ENABLE	 (1u << 0)
+#define CNTV_CTL_IMASK	 (1u << 1)
+#define CNTV_CTL_ISTATUS (1u << 2)
+
+/* Counter frequency in Hz */
+static inline uint32_t generic_timer_freq(void)
+{
+	uint32_t freq;
+	asm volatile("mrc p15, 0, %0, c14, c0, 0" : "=r"(freq));
+	return freq;
+}
+
+/*
+ * Virtual count CNTVCT. Not the kernel timestamp even with
+ * TICK_GENERIC_TIMER: hrtimer deadlines are systimer C3 compare values
+ * and RT deadlines, the time page and SYSCALL_TIME are compared against
+ * them, so all of them stay on systimer_now(). A second time base would
+ * drift against C3, the tick source alone does not change that.
+ */
+static inline uint64_t generic_timer_count(void)
+{
+	uint32_t lo, hi;
+	asm volatile("isb; mrrc p15, 1, %0, %1, c14" : "=r"(lo), "=r"(hi));
+	return ((uint64_t)hi << 32) | lo;
+}
+
+static inline void generic_timer_set_cval(uint64_t cval)
+{
+	asm volatile("mcrr p15, 3, %0, %1, c14" : : "r"((uint32_t)cval), "r"((uint32_t)(cval >> 32)));
+}
+
+static inline uint64_t generic_timer_get_cval(void)
+{
+	uint32_t lo, hi;
+	asm volatile("mrrc p15, 3, %0, %1, c14" : "=r"(lo), "=r"(hi));
+	return ((uint64_t)hi << 32) | lo;
+}
+
+static inline void generic_timer_set_ctl(uint32_t ctl)
+{
+	asm volatile("mcr p15, 0, %0, c14, c3, 1; isb" : : "r"(ctl));
+}
+
+/* Physical view (CNTP), never used for the tick. Same control bits as CNTV. */
+static inline uint64_t generic_timer_phys_count(void)
+{
+	uint32_t lo, hi;
+	asm volatile("isb; mrrc p15, 0, %0, %1, c14" : "=r"(lo), "=r"(hi));
+	return ((uint64_t)hi << 32) | lo;
+}
+
+static inline void generic_timer_phys_set_cval(uint64_t cval)
+{
+	asm volatile("mcrr p15, 2, %0, %1, c14" : : "r"((uint32_t)cval), "r"((uint32_t)(cval >> 32)));
+}
+
+static inline uint64_t generic_timer_phys_get_cval(void)
+{
+	uint32_t lo, hi;
+	asm volatile("mrrc p15, 2, %0, %1, c14" : "=r"(lo), "=r"(hi));
+	return ((uint64_t)hi << 32) | lo;
+}
+
+static inline void generic_timer_phys_set_ctl(uint32_t ctl)
+{
+	asm volatile("mcr p15, 0, %0, c14, c2, 1; isb" : : "r"(ctl));
+}
+
+/* Uses the generic timer as scheduler tick if TICK_GENERIC_TIMER is set */
+void generic_timer_init(void);
+
+/* Counts per µs times 1024, for converting counts without 64 bit division */
+uint32_t generic_timer_counts_per_us_q10(void);
+
+/* Worst delay between the compare value and the tick handler in µs */
+uint32_t generic_timer_irq_latency_max(void);
+void	 generic_timer_irq_latency_reset(void);
+
+#endif
@@ -3,9 +3,13 @@
 
 #include <stdint.h>
 
+/*
+ * Register frame pushed by the exception entry onto the SVC stack of the
+ * interrupted thread. The layout is fixed by interrupt_vector_table.S.
+ */
 typedef struct {
-	uint32_t spsr;
-	uint32_t sp;
+	uint32_t sp; // banked user sp
+	uint32_t usr_lr; // banked user lr
 	uint32_t r0;
 	uint32_t r1;
 	uint32_t r2;
@@ -19,7 +23,9 @@ typedef struct {
 	uint32_t r10;
 	uint32_t r11;
 	uint32_t r12;
-	uint32_t lr;
+	uint32_t svc_lr; // lr of an interrupted kernel context
+	uint32_t lr; // return address
+	uint32_t spsr;
 } exc_frame_t;
 
 void software_interrupt_c(exc_frame_t *frame);
@@ -30,4 +36,13 @@ void prefetch_abort_c(exc_frame_t *frame);
 void data_abort_c(exc_frame_t *frame);
 void not_used_c(exc_frame_t *frame);
 
+/* Frame of the interrupted context, only valid inside an IRQ handler */
+exc_frame_t *irq_get_frame(void);
+
+/* PMU cycle count when irq_c was entered for the IRQ being handled */
+uint32_t irq_get_entry_cycles(void);
+
+/* Restores the frame at r4 and returns from the exception */
+void exc_return(void);
+
 #endif
@@ -0,0 +1,71 @@
+#ifndef ARCH_CPU_IRQ_FLAGS_H
+#define ARCH_CPU_IRQ_FLAGS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <arch/cpu/psr.h>
+#include <kernel/irqsoff.h>
+#include <kernel/kconfig.h>
+
+/*
+ * Critical sections only mask IRQs. FIQs stay enabled so a FIQ source
+ * is never delayed by kernel code.
+ *
+ * The primitives are always inlined, also without optimization, so the
+ * IRQ-off tracer sees the address of the call site and not of a helper.
+ */
+
+[[gnu::always_inline]] static inline uint32_t irqsoff_site(void)
+{
+	uint32_t site;
+	asm volatile("adr %0, ." : "=r"(site));
+	return site;
+}
+
+[[gnu::always_inline]] static inline bool irqs_disabled(void)
+{
+	uint32_t cpsr;
+	asm volatile("mrs %0, cpsr" : "=r"(cpsr));
+	return cpsr & PSR_I;
+}
+
+[[gnu::always_inline]] static inline uint32_t local_irq_save(void)
+{
+	uint32_t flags;
+	asm volatile("mrs %0, cpsr\n\t"
+		     "cpsid i"
+		     : "=r"(flags)
+		     :
+		     : "memory");
+	if (IRQSOFF_TRACER && !(flags & PSR_I)) {
+		irqsoff_begin(irqsoff_site());
+	}
+	return flags;
+}
+
+[[gnu::always_inline]] static inline void local_irq_restore(uint32_t flags)
+{
+	if (IRQSOFF_TRACER && !(flags & PSR_I) && irqs_disabled()) {
+		irqsoff_end(irqsoff_site());
+	}
+	asm volatile("msr cpsr_c, %0" : : "r"(flags) : "memory");
+}
+
+[[gnu::always_inline]] static inline void local_irq_enable(void)
+{
+	if (IRQSOFF_TRACER && irqs_disabled()) {
+		irqsoff_end(irqsoff_site());
+	}
+	asm volatile("cpsie i" : : : "memory");
+}
+
+[[gnu::always_inline]] static inline void local_irq_disable(void)
+{
+	bool was_enabled = IRQSOFF_TRACER && !irqs_disabled();
+	asm volatile("cpsid i" : : : "memory");
+	if (was_enabled) {
+		irqsoff_begin(irqsoff_site());
+	}
+}
+
+#endif
@@ -0,0 +1,29 @@
+#ifndef ARCH_CPU_PMU_H
+#define ARCH_CPU_PMU_H
+
+#include <stdint.h>
+
+#define PMCR_E (1u << 0) // enable all counters
+#define PMCR_C (1u << 2) // reset cycle counter
+
+#define PMCNTEN_CYCLES (1u << 31)
+
+#define PMUSERENR_EN (1u << 0) // counters readable from user mode
+
+/* Starts the free running cycle counter, user threads may read it too */
+static inline void pmu_init(void)
+{
+	asm volatile("mcr p15, 0, %0, c9, c12, 0" : : "r"(PMCR_E | PMCR_C));
+	asm volatile("mcr p15, 0, %0, c9, c12, 1" : : "r"(PMCNTEN_CYCLES));
+	asm volatile("mcr p15, 0, %0, c9, c14, 0" : : "r"(PMUSERENR_EN));
+}
+
+/* Cycle counter (PMCCNTR) */
+static inline uint32_t pmu_cycles(void)
+{
+	uint32_t cycles;
+	asm volatile("mrc p15, 0, %0, c9, c13, 0" : "=r"(cycles));
+	return cycles;
+}
+
+#endif
@@ -0,0 +1,16 @@
+#ifndef ARCH_CPU_PSR_H
+#define ARCH_CPU_PSR_H
+
+#define PSR_MODE_MASK 0x1F
+#define PSR_USR	      0x10
+#define PSR_FIQ	      0x11
+#define PSR_IRQ	      0x12
+#define PSR_SVC	      0x13
+#define PSR_ABT	      0x17
+#define PSR_UND	      0x1B
+#define PSR_SYS	      0x1F
+
+#define PSR_F (1 << 6)
+#define PSR_I (1 << 7)
+
+#endif
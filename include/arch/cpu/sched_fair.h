@@ -0,0 +1,52 @@
+#ifndef ARCH_CPU_SCHED_FAIR_H
+#define ARCH_CPU_SCHED_FAIR_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+typedef struct tcb tcb_t;
+
+#define SCHED_FAIR_WEIGHT_DEFAULT 1024
+
+/*
+ * Fair share class: every ready thread accrues virtual runtime, the
+ * real runtime scaled by SCHED_FAIR_WEIGHT_DEFAULT / weight, and the
+ * thread with the smallest one runs next. Ready threads are kept in a
+ * binary min-heap, the running thread is not part of it.
+ */
+struct sched_fair {
+	uint64_t vruntime;
+	uint32_t weight;
+	uint32_t inv_weight; // ceil(2^32 / weight), avoids a division per charge
+	int	 heap_index; // -1 while not queued
+};
+
+/* Resets the entity of a new thread to the current minimum vruntime */
+void sched_fair_init_thread(tcb_t *thread);
+void sched_fair_set_weight(tcb_t *thread, uint32_t weight);
+
+/*
+ * Queues a ready thread. Woken sleepers are placed at most
+ * SCHED_FAIR_SLEEPER_CREDIT µs behind the minimum vruntime.
+ */
+void sched_fair_enqueue(tcb_t *thread, bool wakeup);
+void sched_fair_dequeue(tcb_t *thread);
+
+/* Removes and returns the thread with the smallest vruntime */
+tcb_t *sched_fair_pick_next(void);
+
+/* Adds delta_us of runtime to the running thread */
+void sched_fair_charge(tcb_t *thread, uint32_t delta_us);
+
+bool sched_fair_tick(tcb_t *current);
+
+/* Moves current behind the leftmost queued thread */
+void sched_fair_yield(tcb_t *current);
+
+/*
+ * True if woken is more than SCHED_FAIR_WAKEUP_GRANULARITY behind
+ * current, whose vruntime includes the part of its slice run so far.
+ */
+bool sched_fair_wakeup_preempt(tcb_t *current, tcb_t *woken);
+
+#endif
@@ -0,0 +1,45 @@
+#ifndef ARCH_CPU_SCHED_MLFQ_H
+#define ARCH_CPU_SCHED_MLFQ_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <lib/list.h>
+
+typedef struct tcb tcb_t;
+
+/*
+ * Multilevel feedback queue. Level 0 has the shortest quantum, a thread
+ * that uses up its quantum drops one level, a thread that wakes up
+ * after blocking rises one. Every MLFQ_BOOST_PERIOD all threads return
+ * to level 0 so CPU bound threads cannot starve.
+ */
+struct sched_mlfq {
+	list_node node;
+	uint32_t  level;
+	uint32_t  slice_left; // µs left of the quantum of level
+	uint32_t  boost_gen;
+	bool	  queued;
+};
+
+void sched_mlfq_init(void);
+void sched_mlfq_init_thread(tcb_t *thread);
+
+void sched_mlfq_enqueue(tcb_t *thread, bool wakeup);
+void sched_mlfq_dequeue(tcb_t *thread);
+
+/* Removes and returns the first thread of the highest non empty level */
+tcb_t *sched_mlfq_pick_next(void);
+
+/* Adds delta_us of runtime, demotes the thread once its quantum is used */
+void sched_mlfq_charge(tcb_t *thread, uint32_t delta_us);
+
+/* The global tick never preempts, quanta are enforced by their own timer */
+bool sched_mlfq_tick(tcb_t *current);
+
+/* Arms the quantum timer for next, nullptr if next is not an MLFQ thread */
+void sched_mlfq_start_slice(tcb_t *next);
+
+/* True if woken was queued on a higher level than the one current runs on */
+bool sched_mlfq_wakeup_preempt(tcb_t *current, tcb_t *woken);
+
+#endif
@@ -0,0 +1,40 @@
+#ifndef ARCH_CPU_SCHED_POLICY_H
+#define ARCH_CPU_SCHED_POLICY_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+typedef struct tcb tcb_t;
+
+/*
+ * Operations of a policy for normal threads (neither RT nor urgent).
+ * The scheduler picks the policy at build time through SCHED_POLICY in
+ * kconfig.h. Its policy_*() helpers switch on that constant and call
+ * sched_<policy>_<op>() directly, so no call goes through a pointer even
+ * in the -O0 build. A policy leaves out the operations it has no use
+ * for. All operations run with IRQs disabled.
+ *
+ * init()			once before the first thread is created
+ * init_thread(thread)		a new thread is set up
+ * enqueue(thread, wakeup)	thread became ready, wakeup if it was blocked
+ * dequeue(thread)		thread leaves the policy while queued
+ * pick_next()			removes and returns the next thread, nullptr
+ *				lets the idle thread run
+ * charge(thread, delta_us)	runtime of thread when the CPU switches away
+ * tick(current)		periodic tick, true if current is preempted
+ * yield(current)		current gives up the CPU, before it is queued
+ * switch_in(next)		next is about to run, nullptr if it does not
+ *				belong to the policy
+ * wakeup_preempt(current, woken)
+ *				woken was just queued, true if it should
+ *				preempt current
+ */
+
+/* Round robin in thread id order, the original policy */
+void   sched_rr_init(void);
+void   sched_rr_enqueue(tcb_t *thread, bool wakeup);
+void   sched_rr_dequeue(tcb_t *thread);
+tcb_t *sched_rr_pick_next(void);
+bool   sched_rr_tick(tcb_t *current);
+
+#endif
@@ -0,0 +1,70 @@
+#ifndef ARCH_CPU_SCHED_RT_H
+#define ARCH_CPU_SCHED_RT_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <kernel/hrtimer.h>
+#include <lib/list.h>
+
+typedef struct tcb tcb_t;
+
+/*
+ * Earliest deadline first class for periodic threads. Every period a
+ * job is released with runtime µs of budget that has to finish before
+ * release + deadline. RT threads run before normal threads, only the
+ * urgent bottom half workers preempt them.
+ */
+struct sched_rt {
+	list_node      node;
+	struct hrtimer release_timer;
+	uint32_t       runtime;
+	uint32_t       period;
+	uint32_t       deadline;
+
+	uint32_t abs_deadline;
+	uint32_t budget_left;
+	uint32_t exec_start;
+	bool	 active;
+	bool	 throttled; // budget used up, waits for the next release
+	bool	 job_done;
+	bool	 waiting; // blocked in sched_rt_wait_period
+
+	uint32_t jobs;
+	uint32_t missed;
+
+	// Deadline inherited from a thread blocked on a mutex this thread holds
+	list_node pi_node;
+	uint32_t  pi_deadline;
+	bool	  pi_active;
+};
+
+/*
+ * Moves thread into the RT class. Returns -1 if the parameters are
+ * invalid or the total density would exceed RT_UTIL_MAX_PERMILLE.
+ * The first job is released immediately.
+ */
+int  sched_rt_set(tcb_t *thread, uint32_t runtime, uint32_t period, uint32_t deadline);
+void sched_rt_clear(tcb_t *thread);
+
+/*
+ * Ready RT or deadline boosted thread with the earliest deadline,
+ * nullptr if there is none. Boosted threads run even when throttled.
+ */
+tcb_t *sched_rt_pick_next(void);
+
+/* Deadline thread is scheduled by, false if it has none */
+bool sched_rt_deadline(const tcb_t *thread, uint32_t *deadline);
+
+/* Priority inheritance, use scheduler_pi_boost/unboost instead */
+void sched_rt_pi_set(tcb_t *thread, uint32_t deadline);
+void sched_rt_pi_clear(tcb_t *thread);
+
+/* Budget accounting on every switch, called with IRQs disabled */
+void sched_rt_switch(tcb_t *prev, tcb_t *next);
+
+/* Ends the current job and blocks until the next release */
+void sched_rt_wait_period(void);
+
+void sched_rt_print_stats(void);
+
+#endif
@@ -4,21 +4,26 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include <arch/cpu/interrupts.h>
+#include <lib/list.h>
+#include <arch/cpu/sched_policy.h>
+#include <arch/cpu/sched_rt.h>
+#include <arch/cpu/sched_fair.h>
+#include <arch/cpu/sched_mlfq.h>
+#include <kernel/ipc.h>
 #define MAX_THREADS	  32
 #define THREAD_STACK_SIZE 1024
+#define KERNEL_STACK_SIZE 4096
 #define IDLE_THREAD_ID	  0
 
 typedef enum {
 	THREAD_STATE_READY,
 	THREAD_STATE_RUNNING,
+	THREAD_STATE_BLOCKED,
 	THREAD_STATE_TERMINATED
 } thread_state_t;
 
+/* Kernel context saved by cpu_switch_to, layout fixed by context_switch.S */
 typedef struct {
-	uint32_t r0;
-	uint32_t r1;
-	uint32_t r2;
-	uint32_t r3;
 	uint32_t r4;
 	uint32_t r5;
 	uint32_t r6;
@@ -27,25 +32,75 @@ typedef struct {
 	uint32_t r9;
 	uint32_t r10;
 	uint32_t r11;
-	uint32_t r12;
 	uint32_t sp;
 	uint32_t lr;
-	uint32_t pc;
-	uint32_t cpsr;
-} thread_context_t;
+} cpu_context_t;
 
-typedef struct {
-	thread_context_t context;
-	thread_state_t	 state;
-	uint32_t	 thread_id;
-	uint8_t		 stack[THREAD_STACK_SIZE];
+typedef struct tcb tcb_t;
+
+typedef struct tcb {
+	cpu_context_t context;
+	thread_state_t state;
+	uint32_t       thread_id;
+	uint32_t       preempt_count;
+	bool	       urgent; // picked before all other ready threads
+	void (*exit_hook)(tcb_t *thread);
+	list_node      wait_node;
+	exc_frame_t   *frame; // user context at the top of the kernel stack
+	struct sched_rt rt;
+	struct sched_fair fair;
+	struct sched_mlfq mlfq;
+	uint32_t	  exec_start;
+	uint64_t	  exec_total; // µs spent running
+	volatile uint32_t *futex_addr; // futex word the thread is blocked on
+	bool		   futex_pi;
+	struct ipc	   ipc;
+	uint8_t	       stack[THREAD_STACK_SIZE];
+	uint8_t	       kstack[KERNEL_STACK_SIZE];
 } tcb_t;
+
 void   scheduler_init(void);
 void   scheduler_start [[noreturn]] (void);
-void   scheduler_thread_create(void (*func)(void *), const void *arg, unsigned int arg_size);
-void   scheduler_schedule(void);
-void   scheduler_terminate_current_thread(void);
+int    scheduler_thread_create(void (*func)(void *), const void *arg, unsigned int arg_size);
+int    scheduler_kthread_create(void (*func)(void *), void *arg);
+void   scheduler_exit [[noreturn]] (void);
+void   scheduler_yield(void);
+void   scheduler_sleep(uint32_t ticks);
+void   scheduler_tick(void);
+uint32_t scheduler_jiffies(void);
+void   scheduler_preempt_point(void);
+void   scheduler_block_current(void);
+void   scheduler_wake(tcb_t *thread);
+void   scheduler_need_resched(void);
+
+/*
+ * Switches straight to the blocked thread next without going through
+ * pick_next, for IPC rendezvous. The caller has set its own state,
+ * IRQs must be disabled. If a reschedule is pending or next ranks below
+ * the caller (urgent > RT > normal), next is only woken and the CPU goes
+ * to whichever thread pick_next chooses. Returns whether it switched
+ * directly.
+ */
+bool scheduler_handoff(tcb_t *next);
+
+/*
+ * Priority inheritance: thread runs on deadline ahead of its own class
+ * until it is unboosted, even if it is a normal thread.
+ */
+void scheduler_pi_boost(tcb_t *thread, uint32_t deadline);
+void scheduler_pi_unboost(tcb_t *thread);
+void   scheduler_set_urgent(int tid);
+void   scheduler_set_exit_hook(int tid, void (*hook)(tcb_t *thread));
 tcb_t *scheduler_get_current_thread(void);
-void   syscall_exit(void);
-void   scheduler_context_switch(exc_frame_t *frame);
+tcb_t *scheduler_get_thread(int tid);
+bool   scheduler_is_user_thread(const tcb_t *thread);
+const char *scheduler_policy_name(void);
+bool	    scheduler_policy_tick(void);
+void   scheduler_print_stats(void);
+void   scheduler_reset_stats(void);
+
+void preempt_disable(void);
+void preempt_enable(void);
+
+void cpu_switch_to(cpu_context_t *prev, cpu_context_t *next);
 #endif
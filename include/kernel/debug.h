@@ -0,0 +1,14 @@
+#ifndef KERNEL_DEBUG_H
+#define KERNEL_DEBUG_H
+
+#include <stdbool.h>
+
+/*
+ * Debug commands on the UART input: 'I' prints the stats of all
+ * subsystems, 'R' the profile and 'T' the IRQ-off windows. Returns
+ * whether c was one of them, always false without UART_DEBUG_KEYS so
+ * main() keeps every letter.
+ */
+bool debug_key(char c);
+
+#endif
@@ -0,0 +1,44 @@
+#ifndef KERNEL_FUTEX_H
+#define KERNEL_FUTEX_H
+
+#include <stdint.h>
+
+typedef struct tcb tcb_t;
+
+/*
+ * Kernel side of the user space mutexes, semaphores and condition
+ * variables. The fast paths run in user space with ldrex/strex, only
+ * contended operations enter the kernel.
+ *
+ * A PI mutex word holds the thread id of its owner, 0 if unlocked, and
+ * FUTEX_WAITERS while threads are blocked on it.
+ */
+#define FUTEX_WAITERS  (1u << 31)
+#define FUTEX_TID_MASK 0xFFFFu
+
+void futex_init(void);
+
+/* Blocks while *addr == expected, returns -1 at once if it differs */
+int futex_wait(volatile uint32_t *addr, uint32_t expected);
+
+/* Wakes up to count threads blocked on addr, returns how many */
+int futex_wake(volatile uint32_t *addr, uint32_t count);
+
+/*
+ * Acquires a PI mutex whose fast path failed. The owner inherits the
+ * deadline of the caller until it unlocks. On unlock the mutex is handed
+ * to the waiter with the earliest deadline.
+ */
+int futex_lock_pi(volatile uint32_t *addr);
+int futex_unlock_pi(volatile uint32_t *addr);
+
+/*
+ * Hands the contended PI mutexes still held by thread, which is about to
+ * exit, to their waiters. An uncontended one keeps the dead id, the next
+ * futex_lock_pi takes it over unless a new thread got the slot first.
+ */
+void futex_thread_exit(tcb_t *thread);
+
+void futex_print_stats(void);
+
+#endif
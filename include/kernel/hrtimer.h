@@ -0,0 +1,39 @@
+#ifndef KERNEL_HRTIMER_H
+#define KERNEL_HRTIMER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <lib/list.h>
+
+/*
+ * High resolution software timers on systimer compare channel 3.
+ * Deadlines are absolute systimer times in µs, callbacks run in IRQ
+ * context and must not block.
+ */
+struct hrtimer {
+	list_node node;
+	uint32_t  expires;
+	uint32_t  period; // 0 for one-shot timers
+	void (*func)(struct hrtimer *timer);
+	bool	  active;
+
+	uint32_t expirations;
+	uint32_t jitter_max; // worst delay of the callback behind expires
+};
+
+#define HRTIMER_INIT(fn) { .func = (fn) }
+
+void hrtimer_init(void);
+
+/*
+ * Arms timer to fire delay_us from now and then every period_us (0 = once).
+ * The callback never runs inside hrtimer_start, a delay of 0 fires from
+ * the next C3 IRQ a few µs later.
+ */
+void hrtimer_start(struct hrtimer *timer, uint32_t delay_us, uint32_t period_us);
+void hrtimer_cancel(struct hrtimer *timer);
+
+void hrtimer_print_stats(void);
+void hrtimer_reset_stats(void);
+
+#endif
@@ -0,0 +1,29 @@
+#ifndef KERNEL_INPUT_POOL_H
+#define KERNEL_INPUT_POOL_H
+
+#include <stdint.h>
+
+/*
+ * Dispatch of UART input events to main(). With INPUT_THREAD_POOL a
+ * fixed set of parked user threads takes events from a bounded queue,
+ * otherwise every event gets a new thread.
+ */
+void input_pool_init(void);
+
+/* Hands one input character to main(), called from the input bottom half */
+void input_event_post(char c);
+
+/* Blocks the calling worker until an event is available */
+char input_pool_take(void);
+
+struct input_stats {
+	uint32_t processed; // handed to main(), taken by a worker or a new thread
+	uint32_t dropped;   // queue full or no free thread slot
+	uint32_t rate_last; // chars/s in the last full 1 s window of a burst
+	uint32_t rate_peak; // highest rate_last so far
+};
+
+void input_get_stats(struct input_stats *stats);
+void input_print_stats(void);
+
+#endif
@@ -0,0 +1,53 @@
+#ifndef KERNEL_IPC_H
+#define KERNEL_IPC_H
+
+#include <stdint.h>
+#include <arch/cpu/interrupts.h>
+#include <lib/list.h>
+#include <user/ipc.h>
+
+typedef struct tcb tcb_t;
+
+/*
+ * Synchronous rendezvous IPC between user threads. A message is up to
+ * IPC_MSG_WORDS words passed in r1-r6 of the exception frames, it is
+ * copied straight from sender to receiver without a kernel buffer.
+ * If the partner already waits, the kernel switches to it directly
+ * instead of going through the ready queue.
+ *
+ * Register contract of the syscalls:
+ *   send:         r0 = dest, r1-r6 = msg      -> r0 = 0 or -1
+ *   receive:      r0 = from or IPC_ANY         -> r0 = sender, r1-r6 = msg
+ *   call:         r0 = dest, r1-r6 = msg      -> r0 = 0 or -1, r1-r6 = reply
+ *   reply:        r0 = client, r1-r6 = msg    -> r0 = 0 or -1
+ *   reply_receive: reply, then receive from r7 -> like receive
+ */
+
+enum ipc_state {
+	IPC_NONE,
+	IPC_RECV_WAIT, // blocked in receive
+	IPC_SEND_WAIT, // queued at the receiver
+	IPC_CALL_SEND, // queued at the receiver, then waits for the reply
+	IPC_CALL_WAIT, // message delivered, waits for the reply
+};
+
+struct ipc {
+	enum ipc_state state;
+	uint32_t       partner; // receiver, server or accepted sender
+	list_node      senders; // threads queued sending to this one
+};
+
+void ipc_thread_init(tcb_t *thread);
+
+/* Fails all IPC partners of thread, which is about to exit */
+void ipc_thread_exit(tcb_t *thread);
+
+void ipc_handle_send(exc_frame_t *frame);
+void ipc_handle_receive(exc_frame_t *frame);
+void ipc_handle_call(exc_frame_t *frame);
+void ipc_handle_reply(exc_frame_t *frame);
+void ipc_handle_reply_receive(exc_frame_t *frame);
+
+void ipc_print_stats(void);
+
+#endif
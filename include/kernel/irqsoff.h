@@ -0,0 +1,19 @@
+#ifndef KERNEL_IRQSOFF_H
+#define KERNEL_IRQSOFF_H
+
+#include <stdint.h>
+
+/*
+ * IRQ-off tracer. With IRQSOFF_TRACER set, the primitives in
+ * arch/cpu/irq_flags.h report every enabled -> disabled transition and
+ * the matching way back, with the address of the instruction that made
+ * it. The IRQSOFF_TOP longest windows are kept per pair of call sites.
+ * Exception entries start a window too, their exit from C ends it.
+ */
+void irqsoff_begin(uint32_t site);
+void irqsoff_end(uint32_t site);
+
+/* Prints the longest windows and starts over, the sites resolve with addr2line */
+void irqsoff_dump(void);
+
+#endif
@@ -0,0 +1,83 @@
+#ifndef KERNEL_KCONFIG_H
+#define KERNEL_KCONFIG_H
+
+/**
+ * \file kconfig.h
+ *
+ * Build time options of the kernel itself. config.h is reserved for the
+ * values exchanged by the test setup, kernel options live here.
+ */
+
+#ifndef __ASSEMBLER__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// PL011 RX via FIQ into a ring buffer instead of the UART IRQ
+#ifdef UART_RX_FIQ_SELECT
+// Set by tests/uart_rx_flood.sh to build both RX paths in turn
+static constexpr bool UART_RX_FIQ = UART_RX_FIQ_SELECT;
+#else
+static constexpr bool UART_RX_FIQ = false;
+#endif
+
+// Debug commands on 'I' (stats), 'R' (profile) and 'T' (irqsoff) instead of input
+static constexpr bool UART_DEBUG_KEYS = false;
+
+// Input characters go to parked pool workers instead of a new thread each
+#ifdef INPUT_THREAD_POOL_SELECT
+// Set by tests/input_rate.sh to build both designs in turn
+static constexpr bool INPUT_THREAD_POOL = INPUT_THREAD_POOL_SELECT;
+#else
+static constexpr bool INPUT_THREAD_POOL = true;
+#endif
+static constexpr unsigned int INPUT_POOL_WORKERS     = 4;
+static constexpr unsigned int INPUT_EVENT_QUEUE_SIZE = 64;
+
+// Scheduler tick from the per core generic timer instead of systimer C1
+static constexpr bool TICK_GENERIC_TIMER = false;
+
+// Policy for normal (not RT, not urgent) threads
+enum sched_policy {
+	SCHED_POLICY_RR,   // round robin over the thread table
+	SCHED_POLICY_FAIR, // smallest weighted virtual runtime first
+	SCHED_POLICY_MLFQ, // multilevel feedback queue with per level quanta
+};
+#ifdef SCHED_POLICY_SELECT
+// Set by tests/sched_bench.sh to build every policy in turn
+static constexpr enum sched_policy SCHED_POLICY = SCHED_POLICY_SELECT;
+#else
+static constexpr enum sched_policy SCHED_POLICY = SCHED_POLICY_RR;
+#endif
+
+// How far behind the minimum vruntime a woken thread may start, in µs
+static constexpr uint64_t SCHED_FAIR_SLEEPER_CREDIT = 3000;
+// Vruntime lead in µs a woken thread needs to preempt the running one
+static constexpr uint64_t SCHED_FAIR_WAKEUP_GRANULARITY = 1000;
+
+// MLFQ quanta per level in µs and the period of the reset to level 0
+static constexpr unsigned int MLFQ_LEVELS		= 3;
+static constexpr uint32_t     MLFQ_QUANTUM[MLFQ_LEVELS] = { 2000, 8000, 32000 };
+static constexpr uint32_t     MLFQ_BOOST_PERIOD		= 200000;
+
+// Admission bound of the EDF class, sum of runtime/deadline in 1/1000
+static constexpr unsigned int RT_UTIL_MAX_PERMILLE = 950;
+
+// RAM handed out page by page to the user heap, far above the kernel image
+static constexpr uint32_t USER_HEAP_BASE = 0x01000000;
+static constexpr uint32_t USER_HEAP_SIZE = 0x00400000;
+
+// Update period of the user time page in µs, at most 65 ms for its scaling
+static constexpr uint32_t TIME_PAGE_PERIOD_US = 10000;
+
+// Sampling profiler on the physical generic timer, dumped with the 'R' debug key
+static constexpr bool	      PROFILE_SAMPLING	= false;
+static constexpr uint32_t     PROFILE_PERIOD_US = 1000;
+static constexpr unsigned int PROFILE_SAMPLES	= 4096;
+
+// Times every IRQ-off section, the 'T' debug key dumps the IRQSOFF_TOP longest
+static constexpr bool	      IRQSOFF_TRACER = false;
+static constexpr unsigned int IRQSOFF_TOP    = 8;
+
+#endif // __ASSEMBLER__
+#endif // KERNEL_KCONFIG_H
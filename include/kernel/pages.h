@@ -0,0 +1,22 @@
+#ifndef KERNEL_PAGES_H
+#define KERNEL_PAGES_H
+
+#include <stdint.h>
+
+#define PAGE_SIZE 4096
+
+/*
+ * The user heap: a contiguous region between USER_HEAP_BASE and a break
+ * that moves in whole pages. All user threads share it, like they share
+ * the rest of the address space.
+ */
+
+/*
+ * Moves the break by pages (may be negative) and returns the old break,
+ * nullptr if that would leave the region. Fresh pages are zeroed.
+ */
+void *pages_sbrk(int32_t pages);
+
+void pages_print_stats(void);
+
+#endif
@@ -0,0 +1,18 @@
+#ifndef KERNEL_POLL_H
+#define KERNEL_POLL_H
+
+#include <stdint.h>
+#include <user/poll.h>
+
+/*
+ * Kernel side of sys_poll. All pollers sleep on one wait queue and
+ * check their sources again on every notification, the event sources
+ * call poll_notify from their IRQ and wake up paths.
+ */
+uint32_t poll_wait(uint32_t events, uint32_t timeout_us);
+
+void poll_notify(void);
+
+void poll_print_stats(void);
+
+#endif
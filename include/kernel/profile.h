@@ -0,0 +1,18 @@
+#ifndef KERNEL_PROFILE_H
+#define KERNEL_PROFILE_H
+
+/*
+ * Sampling profiler. Every PROFILE_PERIOD_US the physical generic timer
+ * interrupts whatever runs and the interrupted pc, lr, mode and thread
+ * are stored in a RAM buffer. profile_dump prints the buffer as
+ * "profile_sample" lines for tests/profile.sh, which symbolizes them.
+ */
+void profile_init(void);
+
+void profile_start(void);
+void profile_stop(void);
+
+/* Prints and clears the buffer, sampling continues if it was running */
+void profile_dump(void);
+
+#endif
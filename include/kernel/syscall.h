@@ -0,0 +1,14 @@
+#ifndef KERNEL_SYSCALL_H
+#define KERNEL_SYSCALL_H
+
+#include <stdbool.h>
+#include <arch/cpu/interrupts.h>
+
+/*
+ * Runs the syscall encoded in the svc instruction before frame->lr.
+ * Arguments are passed in r0-r3, the result is returned in r0.
+ * Returns false for unknown syscall numbers.
+ */
+bool syscall_dispatch(exc_frame_t *frame);
+
+#endif
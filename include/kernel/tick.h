@@ -0,0 +1,7 @@
+#ifndef KERNEL_TICK_H
+#define KERNEL_TICK_H
+
+/* Periodic scheduler tick, called from the IRQ of the configured tick source */
+void tick_handle_periodic(void);
+
+#endif
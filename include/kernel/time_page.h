@@ -0,0 +1,18 @@
+#ifndef KERNEL_TIME_PAGE_H
+#define KERNEL_TIME_PAGE_H
+
+#include <user/time.h>
+
+/*
+ * Starts the periodic update of the time page. There is no MMU, so the
+ * page is only read-only by convention: user code gets a const pointer
+ * from sys_time_page.
+ */
+void time_page_init(void);
+
+/* Takes a new snapshot, from the tick and from the update timer */
+void time_page_update(void);
+
+const struct time_page *time_page_get(void);
+
+#endif
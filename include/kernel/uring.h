@@ -0,0 +1,25 @@
+#ifndef KERNEL_URING_H
+#define KERNEL_URING_H
+
+#include <stdint.h>
+#include <user/uring.h>
+
+typedef struct tcb tcb_t;
+
+/* Returns the ring id or -1 */
+int uring_register(struct uring *ring, uint32_t flags);
+
+/*
+ * Runs the pending submissions of ring id (unless a poller owns it) and
+ * waits until min_complete completions are ready. min_complete is capped
+ * at URING_ENTRIES and at the completions that are ready or submitted.
+ * Returns the number of operations it ran.
+ */
+int uring_enter(int id, uint32_t min_complete);
+
+/* Drops the rings registered by thread, which is about to exit */
+void uring_thread_exit(tcb_t *thread);
+
+void uring_print_stats(void);
+
+#endif
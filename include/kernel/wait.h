@@ -0,0 +1,41 @@
+#ifndef KERNEL_WAIT_H
+#define KERNEL_WAIT_H
+
+#include <stdbool.h>
+#include <lib/list.h>
+#include <arch/cpu/irq_flags.h>
+
+typedef struct {
+	list_node head;
+} wait_queue_t;
+
+#define WAIT_QUEUE_INIT(name) { { &(name).head, &(name).head } }
+
+void wait_queue_init(wait_queue_t *wq);
+
+/*
+ * Blocks the current thread on wq until it is woken up.
+ * Must be called with IRQs disabled.
+ */
+void wait_queue_sleep(wait_queue_t *wq);
+
+/* Makes all threads waiting on wq runnable again */
+void wake_up(wait_queue_t *wq);
+
+/* Makes the first thread waiting on wq runnable again */
+void wake_up_one(wait_queue_t *wq);
+
+/*
+ * Blocks until condition is true. The condition is re-checked with IRQs
+ * disabled after every wake up, so a wake up can never get lost.
+ */
+#define wait_event(wq, condition)                          \
+	do {                                               \
+		uint32_t __wait_flags = local_irq_save();  \
+		while (!(condition)) {                     \
+			wait_queue_sleep(wq);              \
+		}                                          \
+		local_irq_restore(__wait_flags);           \
+	} while (0)
+
+#endif
@@ -0,0 +1,29 @@
+#ifndef KERNEL_WORKQUEUE_H
+#define KERNEL_WORKQUEUE_H
+
+#include <stdbool.h>
+#include <lib/list.h>
+
+/*
+ * Deferred work (bottom halves). IRQ handlers only acknowledge the
+ * hardware and queue a work item. The item then runs in the kernel
+ * worker thread with IRQs enabled.
+ */
+struct work {
+	list_node node;
+	void (*func)(struct work *work);
+	bool pending;
+};
+
+#define WORK_INIT(name, fn) { .node = { &(name).node, &(name).node }, .func = (fn), .pending = false }
+
+/* Creates the worker thread, must run after scheduler_init */
+void workqueue_init(void);
+
+/*
+ * Queues work, callable from IRQ context. Returns false if the work
+ * was still pending, it then runs only once.
+ */
+bool schedule_work(struct work *work);
+
+#endif
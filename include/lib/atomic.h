@@ -0,0 +1,84 @@
+#ifndef LIB_ATOMIC_H
+#define LIB_ATOMIC_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/*
+ * ldrex/strex based atomics, usable from kernel and user mode. Each
+ * sequence is one asm block so no compiler generated access ends up
+ * between ldrex and strex. A context switch executes clrex, so a
+ * sequence interrupted by another thread fails its strex and retries.
+ */
+
+/* Orders the memory accesses before it against the ones after it */
+static inline void atomic_barrier(void)
+{
+	asm volatile("dmb" : : : "memory");
+}
+
+/* Sets *ptr to new_val if it still holds old_val, returns the value seen */
+static inline uint32_t atomic_cmpxchg(volatile uint32_t *ptr, uint32_t old_val, uint32_t new_val)
+{
+	uint32_t seen;
+	uint32_t failed;
+
+	asm volatile("1:	ldrex	%0, [%2]\n\t"
+		     "	cmp	%0, %3\n\t"
+		     "	bne	2f\n\t"
+		     "	strex	%1, %4, [%2]\n\t"
+		     "	cmp	%1, #0\n\t"
+		     "	bne	1b\n\t"
+		     "	b	3f\n\t"
+		     "2:	clrex\n\t"
+		     "3:"
+		     : "=&r"(seen), "=&r"(failed)
+		     : "r"(ptr), "r"(old_val), "r"(new_val)
+		     : "cc", "memory");
+
+	return seen;
+}
+
+/* Adds delta to *ptr and returns the new value */
+static inline uint32_t atomic_add_return(volatile uint32_t *ptr, int32_t delta)
+{
+	uint32_t val;
+	uint32_t failed;
+
+	asm volatile("1:	ldrex	%0, [%2]\n\t"
+		     "	add	%0, %0, %3\n\t"
+		     "	strex	%1, %0, [%2]\n\t"
+		     "	cmp	%1, #0\n\t"
+		     "	bne	1b"
+		     : "=&r"(val), "=&r"(failed)
+		     : "r"(ptr), "r"(delta)
+		     : "cc", "memory");
+
+	return val;
+}
+
+/* Decrements *ptr if it is above zero, returns false if it was zero */
+static inline bool atomic_dec_if_positive(volatile uint32_t *ptr)
+{
+	uint32_t val;
+	uint32_t failed;
+
+	asm volatile("1:	ldrex	%0, [%2]\n\t"
+		     "	cmp	%0, #0\n\t"
+		     "	beq	2f\n\t"
+		     "	sub	%0, %0, #1\n\t"
+		     "	strex	%1, %0, [%2]\n\t"
+		     "	cmp	%1, #0\n\t"
+		     "	bne	1b\n\t"
+		     "	mov	%0, #1\n\t"
+		     "	b	3f\n\t"
+		     "2:	clrex\n\t"
+		     "3:"
+		     : "=&r"(val), "=&r"(failed)
+		     : "r"(ptr)
+		     : "cc", "memory");
+
+	return val != 0;
+}
+
+#endif
@@ -0,0 +1,33 @@
+#ifndef LIB_HISTOGRAM_H
+#define LIB_HISTOGRAM_H
+
+#include <stdint.h>
+
+/*
+ * Histogram with power of two buckets: bucket 0 counts the value 0,
+ * bucket i the values in [2^(i-1), 2^i). The last bucket takes
+ * everything above. Cheap enough to record from IRQ context.
+ */
+#define HIST_BUCKETS 20
+
+struct log2_hist {
+	uint32_t buckets[HIST_BUCKETS];
+	uint32_t count;
+	uint32_t total;
+	uint32_t min;
+	uint32_t max;
+};
+
+void hist_reset(struct log2_hist *hist);
+void hist_record(struct log2_hist *hist, uint32_t value);
+
+/* Upper bound of the bucket that holds the p-th percentile */
+uint32_t hist_percentile(const struct log2_hist *hist, unsigned int p);
+
+/*
+ * Prints "<prefix> n=.. min=.. avg=.. max=.. p99<=.." and one line per
+ * non-empty bucket as "<prefix> bucket=<low>-<high> count=..".
+ */
+void hist_print(const char *prefix, const struct log2_hist *hist);
+
+#endif
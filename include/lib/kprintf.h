@@ -1,15 +1,15 @@
+#include <stdarg.h>
+
 void kprintf(const char *input, ...);
 
-void print_padding(int width, char pad_char, int content_len);
+/* Receives every character vformat produces, ctx is passed through */
+typedef void (*format_putc_t)(void *ctx, char c);
+
+/* The formatting of kprintf, for output that does not go to the UART directly */
+void vformat(format_putc_t out, void *ctx, const char *fmt, va_list args);
 
 int int_to_str(int value, char *buffer);
 
 int uint_to_str(unsigned int value, char *buffer);
 
 int uint_to_hex_str(unsigned int value, char *buffer);
-
-void send_int_width(int value, int width, char pad_char);
-
-void send_unsigned_width(unsigned int value, int width, char pad_char, bool hex);
-
-void send_pointer(void *ptr);
@@ -8,17 +8,29 @@
  * Sie erspart euch den Aufwand, selber eine doppelt verkettete Liste zu implementieren.
  */
 
+#include <stddef.h>
+
 // List Node struct
 typedef struct list_node {
 	struct list_node *next;
 	struct list_node *prev;
 } list_node;
 
+// Gibt die Struktur zurück, in die der Knoten eingebettet ist
+#define list_entry(node, type, member) ((type *)((char *)(node) - offsetof(type, member)))
+
 // Makro zum initialisieren einer Liste
 #define list_create(N)                                                \
 	static list_node  head__##N = { &(head__##N), &(head__##N) }; \
 	static list_node *N	    = &(head__##N)
 
+// Initialisiert einen eingebetteten Listenkopf
+[[maybe_unused]] static inline void list_init(list_node *head)
+{
+	head->next = head;
+	head->prev = head;
+}
+
 //checks if list is empty
 [[nodiscard]] static inline bool list_is_empty(list_node *head)
 {
@@ -0,0 +1,91 @@
+#ifndef USER_CORO_H
+#define USER_CORO_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <lib/list.h>
+#include <user/sync.h>
+
+/*
+ * Stackful coroutines inside one user thread. A switch saves only the
+ * callee-saved registers, sp and lr and never enters the kernel, the
+ * coroutines of a scheduler take turns round robin whenever one yields.
+ *
+ * Coroutines that have to wait for an event use coro_block: they poll
+ * and yield while other coroutines can run. Once every coroutine of the
+ * scheduler has polled in vain, the thread sleeps on the futex word
+ * wake_seq of the scheduler. Whoever makes a waited for condition true
+ * has to call coro_wake (coro_sem_post does), from any thread; every
+ * waiting coroutine polls again after that, whichever source fired.
+ */
+
+/* Saved by coro_switch, layout fixed by coro_switch.S */
+struct coro_context {
+	uint32_t r4;
+	uint32_t r5;
+	uint32_t r6;
+	uint32_t r7;
+	uint32_t r8;
+	uint32_t r9;
+	uint32_t r10;
+	uint32_t r11;
+	uint32_t sp;
+	uint32_t lr;
+};
+
+struct coro_sched;
+
+struct coro {
+	struct coro_context context;
+	list_node	    node;
+	struct coro_sched  *sched;
+	void (*func)(struct coro_sched *sched, void *arg);
+	void *arg;
+	bool  done;
+};
+
+struct coro_sched {
+	struct coro_context host; // thread that called coro_run
+	struct coro	   *current;
+	list_node	    ready;
+	uint32_t	    live;
+	uint32_t	    waiting; // coroutines inside coro_block
+	uint32_t	    switches;
+	uint32_t	    kernel_blocks;
+
+	volatile uint32_t wake_seq;   // bumped by coro_wake, the thread sleeps on it
+	uint32_t	  round_seq;  // wake_seq when the current polling round began
+	uint32_t	  idle_polls; // polls in vain since then
+};
+
+void coro_sched_init(struct coro_sched *sched);
+
+/* Sets up coro to run func(sched, arg) on stack at the next switch */
+void coro_create(struct coro_sched *sched, struct coro *coro, void *stack, uint32_t stack_size,
+		 void (*func)(struct coro_sched *sched, void *arg), void *arg);
+
+/* Runs the coroutines until all of them have returned */
+void coro_run(struct coro_sched *sched);
+
+/* Passes the CPU to the next ready coroutine, returns at once if there is none */
+void coro_yield(struct coro_sched *sched);
+
+/*
+ * Waits until ready(arg) is true. The condition must only become true
+ * together with a coro_wake on sched, otherwise a sleeping thread does
+ * not notice it.
+ */
+void coro_block(struct coro_sched *sched, bool (*ready)(void *arg), void *arg);
+
+/* Wakes the thread of sched if it sleeps in coro_block, callable from any thread */
+void coro_wake(struct coro_sched *sched);
+
+/* Semaphore wait that only blocks the thread when no other coroutine can run */
+void coro_sem_wait(struct coro_sched *sched, sem_t *sem);
+
+/* sem_post for a semaphore that coroutines of sched wait on */
+void coro_sem_post(struct coro_sched *sched, sem_t *sem);
+
+void coro_switch(struct coro_context *prev, struct coro_context *next);
+
+#endif
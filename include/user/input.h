@@ -0,0 +1,11 @@
+#ifndef USER_INPUT_H
+#define USER_INPUT_H
+
+/*
+ * Body of an input pool worker, see kernel/input_pool.h. Runs in user
+ * mode and hands every input character to main(), a worker lives until
+ * main() ends it.
+ */
+void input_worker(void *arg);
+
+#endif
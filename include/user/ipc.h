@@ -0,0 +1,33 @@
+#ifndef USER_IPC_H
+#define USER_IPC_H
+
+#include <stdint.h>
+
+/*
+ * Synchronous message passing between user threads. Messages are passed
+ * in registers, a send blocks until the receiver takes the message and
+ * switches straight to it if it already waits.
+ */
+#define IPC_MSG_WORDS 6
+#define IPC_ANY	      0xFFFFFFFFu // receive from any sender
+
+struct ipc_msg {
+	uint32_t w[IPC_MSG_WORDS];
+};
+
+/* Returns 0 once dest has taken msg, -1 if dest does not exist or exits */
+int ipc_send(uint32_t dest, const struct ipc_msg *msg);
+
+/* Returns the id of the sender, -1 if the awaited sender exits */
+int ipc_receive(uint32_t from, struct ipc_msg *msg);
+
+/* Sends msg and waits for the reply of dest, which overwrites msg */
+int ipc_call(uint32_t dest, struct ipc_msg *msg);
+
+/* Answers a call, fails if client does not wait for a reply from us */
+int ipc_reply(uint32_t client, const struct ipc_msg *msg);
+
+/* Replies to client and receives the next message into msg in one syscall */
+int ipc_reply_receive(uint32_t client, struct ipc_msg *msg, uint32_t from);
+
+#endif
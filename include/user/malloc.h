@@ -0,0 +1,32 @@
+#ifndef USER_MALLOC_H
+#define USER_MALLOC_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+/*
+ * Heap for user threads on top of sys_sbrk. Small requests are rounded
+ * up to a power of two size class between 16 and 1024 bytes, larger ones
+ * get a run of whole pages.
+ *
+ * Every thread keeps a cache of free objects per class, indexed by the
+ * thread id in TPIDRURO. Allocating and freeing works on that cache
+ * without any lock or syscall. Only refilling an empty cache or
+ * flushing a full one takes the lock of the shared free lists, and only
+ * a shared list running dry asks the kernel for another page.
+ */
+#define MALLOC_THREADS 32 // one cache per thread id, see MAX_THREADS
+
+struct malloc_stats {
+	uint32_t heap_bytes;   // pages taken from the kernel
+	uint32_t in_use_bytes; // handed out, rounded up to class or pages
+	uint32_t cached_bytes; // free in the thread caches
+	uint32_t shared_bytes; // free on the shared lists
+};
+
+void *malloc(size_t size);
+void  free(void *ptr);
+
+void malloc_get_stats(struct malloc_stats *stats);
+
+#endif
@@ -0,0 +1,44 @@
+#ifndef USER_MPMC_H
+#define USER_MPMC_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/*
+ * Bounded lock-free queue for any number of producer and consumer
+ * threads (Vyukov). Every cell carries a sequence number that tells
+ * whether it is free for the producer or filled for the consumer of a
+ * given position, so producers and consumers only contend on their own
+ * position counter. Entries are pointers, bulk data is passed by
+ * reference to a buffer owned by the receiving side from then on.
+ *
+ * mpmc_push and mpmc_pop block on futexes when the queue is full or
+ * empty, the try variants never enter the kernel.
+ */
+struct mpmc_cell {
+	volatile uint32_t seq;
+	void *volatile	  data;
+};
+
+struct mpmc_queue {
+	struct mpmc_cell *cells;
+	uint32_t	  mask;
+	volatile uint32_t enqueue_pos;
+	volatile uint32_t dequeue_pos;
+
+	volatile uint32_t push_seq; // bumped after a push if consumers wait
+	volatile uint32_t pop_seq;  // bumped after a pop if producers wait
+	volatile uint32_t consumers_waiting;
+	volatile uint32_t producers_waiting;
+};
+
+/* size must be a power of two, cells has to hold size entries */
+void mpmc_init(struct mpmc_queue *queue, struct mpmc_cell *cells, uint32_t size);
+
+bool mpmc_try_push(struct mpmc_queue *queue, void *data);
+bool mpmc_try_pop(struct mpmc_queue *queue, void **data);
+
+void  mpmc_push(struct mpmc_queue *queue, void *data);
+void *mpmc_pop(struct mpmc_queue *queue);
+
+#endif
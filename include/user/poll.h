@@ -0,0 +1,22 @@
+#ifndef USER_POLL_H
+#define USER_POLL_H
+
+#include <stdint.h>
+
+/* Event sources for sys_poll, combined as a bit set */
+#define POLL_UART_IN  (1u << 0) // a character can be read without blocking
+#define POLL_UART_OUT (1u << 1) // the UART takes a character without waiting
+#define POLL_TIMEOUT  (1u << 2) // the timeout expired
+#define POLL_IPC      (1u << 3) // a sender is queued, ipc_receive will not block
+
+#define POLL_FOREVER 0xFFFFFFFFu
+
+/*
+ * Blocks until one of events is ready or timeout_us passed and returns
+ * the ready set, POLL_TIMEOUT alone on timeout. A timeout of 0 only
+ * checks the sources. With UART_RX_FIQ there is no TX interrupt,
+ * POLL_UART_OUT is then noticed by a re-check every 200 µs.
+ */
+uint32_t sys_poll(uint32_t events, uint32_t timeout_us);
+
+#endif
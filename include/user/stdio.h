@@ -0,0 +1,30 @@
+#ifndef USER_STDIO_H
+#define USER_STDIO_H
+
+#include <stdint.h>
+
+/*
+ * Buffered output for user threads. Every thread writes into its own
+ * buffer, indexed by the thread id in TPIDRURO, which goes to the UART
+ * in one sys_write on a newline, when it is full, on fflush and when
+ * the thread exits. printf uses the formatter of kprintf.
+ */
+#define STDIO_BUFFER_SIZE 128
+#define STDIO_THREADS	  32 // one buffer per thread id, see MAX_THREADS
+
+struct stdio_stats {
+	uint32_t chars;
+	uint32_t writes; // sys_write calls
+};
+
+int  putchar(int c);
+int  puts(const char *s); // appends a newline like the C library
+void printf(const char *fmt, ...);
+void fflush(void);
+
+/* Drops what a killed thread with the same id left unflushed, called at thread start */
+void stdio_reset(void);
+
+void stdio_get_stats(struct stdio_stats *stats);
+
+#endif
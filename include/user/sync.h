@@ -0,0 +1,52 @@
+#ifndef USER_SYNC_H
+#define USER_SYNC_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/*
+ * Synchronization for user threads. Uncontended operations complete in
+ * user space with ldrex/strex, only contended ones use the futex
+ * syscalls. Mutexes do priority inheritance: the owner runs on the
+ * deadline of an RT thread waiting for it.
+ */
+
+typedef struct {
+	volatile uint32_t word; // owner thread id | FUTEX_WAITERS, 0 if unlocked
+} mutex_t;
+
+typedef struct {
+	volatile uint32_t count;
+	volatile uint32_t waiters;
+} sem_t;
+
+typedef struct {
+	volatile uint32_t seq;
+} cond_t;
+
+#define MUTEX_INIT   { 0 }
+#define SEM_INIT(n)  { (n), 0 }
+#define COND_INIT    { 0 }
+
+/* Thread id, kept in TPIDRURO by the scheduler */
+static inline uint32_t sync_thread_id(void)
+{
+	uint32_t tid;
+	asm volatile("mrc p15, 0, %0, c13, c0, 3" : "=r"(tid));
+	return tid;
+}
+
+void mutex_lock(mutex_t *mutex);
+bool mutex_trylock(mutex_t *mutex);
+void mutex_unlock(mutex_t *mutex);
+
+void sem_wait(sem_t *sem);
+bool sem_trywait(sem_t *sem);
+void sem_post(sem_t *sem);
+
+/* Waits for a signal, mutex is released while waiting and held again on return */
+void cond_wait(cond_t *cond, mutex_t *mutex);
+void cond_signal(cond_t *cond);
+void cond_broadcast(cond_t *cond);
+
+#endif
@@ -0,0 +1,73 @@
+#ifndef USER_SYSCALL_H
+#define USER_SYSCALL_H
+
+#include <stdint.h>
+
+struct time_page;
+struct uring;
+
+/* Syscall numbers, encoded in the immediate of the svc instruction */
+enum syscall_nr {
+	SYSCALL_EXIT = 0,
+	SYSCALL_YIELD,
+	SYSCALL_GETC,
+	SYSCALL_SLEEP,
+	SYSCALL_INPUT_WAIT,
+	SYSCALL_RT_SET,
+	SYSCALL_RT_WAIT,
+	SYSCALL_FUTEX_WAIT,
+	SYSCALL_FUTEX_WAKE,
+	SYSCALL_FUTEX_LOCK_PI,
+	SYSCALL_FUTEX_UNLOCK_PI,
+	SYSCALL_IPC_SEND,
+	SYSCALL_IPC_RECV,
+	SYSCALL_IPC_CALL,
+	SYSCALL_IPC_REPLY,
+	SYSCALL_IPC_REPLY_RECV,
+	SYSCALL_SBRK,
+	SYSCALL_WRITE,
+	SYSCALL_TIME_PAGE,
+	SYSCALL_TIME,
+	SYSCALL_URING_SETUP,
+	SYSCALL_URING_ENTER,
+	SYSCALL_POLL,
+	SYSCALL_NULL,
+	SYSCALL_COUNT
+};
+
+void sys_exit [[noreturn]] (void);
+void sys_yield(void);
+char sys_getc(void);
+/* Parks an input pool worker until the next input character */
+char sys_input_wait(void);
+void sys_sleep(uint32_t ticks);
+/* Writes len characters of buf to the UART, returns len */
+int  sys_write(const char *buf, uint32_t len);
+
+/* Joins the EDF class (all times in µs), returns -1 if not admitted */
+int  sys_rt_set(uint32_t runtime, uint32_t period, uint32_t deadline);
+/* Ends the current job, returns at the next release */
+void sys_rt_wait(void);
+
+/* Slow paths of the primitives in user/sync.h */
+int sys_futex_wait(volatile uint32_t *addr, uint32_t expected);
+int sys_futex_wake(volatile uint32_t *addr, uint32_t count);
+int sys_futex_lock_pi(volatile uint32_t *addr);
+int sys_futex_unlock_pi(volatile uint32_t *addr);
+
+/* Grows (or shrinks) the user heap by whole pages, returns the old break or nullptr */
+void *sys_sbrk(int32_t pages);
+
+/* Where the kernel keeps the time page, see user/time.h */
+const struct time_page *sys_time_page(void);
+/* Systimer in µs, the trapping way to what time_now_us reads without a syscall */
+uint32_t sys_time_us(void);
+
+/* Kernel side of user/uring.h */
+int sys_uring_setup(struct uring *ring, uint32_t flags);
+int sys_uring_enter(int id, uint32_t min_complete);
+
+/* Does nothing, the bare cost of entering and leaving the kernel */
+void sys_null(void);
+
+#endif
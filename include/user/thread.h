@@ -0,0 +1,10 @@
+#ifndef USER_THREAD_H
+#define USER_THREAD_H
+
+/*
+ * First code of every user thread, see scheduler_thread_create. Runs
+ * func(arg) in user mode and exits the thread once func returns.
+ */
+void thread_entry [[noreturn]] (void (*func)(void *), void *arg);
+
+#endif
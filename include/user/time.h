@@ -0,0 +1,47 @@
+#ifndef USER_TIME_H
+#define USER_TIME_H
+
+#include <stdint.h>
+#include <kernel/kconfig.h>
+
+/*
+ * Timestamps for user threads without a syscall. The kernel keeps a
+ * snapshot of the systimer, the tick count and the cycle counter in a
+ * page that user code only reads, a sequence counter tells readers to
+ * retry when they raced with an update. Between updates the time is
+ * extrapolated from the cycle counter, which user mode may read.
+ */
+struct time_page {
+	volatile uint32_t seq; // odd while the kernel updates the page
+	uint32_t	  jiffies;
+	uint64_t	  us;	     // systimer at the update, extended to 64 bit
+	uint32_t	  cycles;    // cycle counter at the same moment
+	uint32_t	  us_per_cycle_q16; // measured between the last two updates
+};
+
+/*
+ * µs the page extrapolates for cycles, at most one update period so a
+ * late update stalls the clock instead of overshooting it. The kernel
+ * never publishes a us below this, which keeps the clock monotonic.
+ */
+static inline uint32_t time_page_extrapolate(const struct time_page *page, uint32_t cycles)
+{
+	uint64_t elapsed = ((uint64_t)(cycles - page->cycles) * page->us_per_cycle_q16) >> 16;
+	return elapsed < TIME_PAGE_PERIOD_US ? (uint32_t)elapsed : TIME_PAGE_PERIOD_US;
+}
+
+/* µs since boot, never goes backwards */
+uint64_t time_now_us(void);
+
+/* Scheduler ticks since boot */
+uint32_t time_jiffies(void);
+
+/* Cycle counter, read straight from user mode */
+static inline uint32_t time_cycles(void)
+{
+	uint32_t cycles;
+	asm volatile("mrc p15, 0, %0, c9, c13, 0" : "=r"(cycles));
+	return cycles;
+}
+
+#endif
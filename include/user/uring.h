@@ -0,0 +1,71 @@
+#ifndef USER_URING_H
+#define USER_URING_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/*
+ * Batched syscalls through a submission and a completion ring shared
+ * with the kernel. User code fills submission entries and hands all of
+ * them over with one sys_uring_enter. With URING_SETUP_SQPOLL a kernel
+ * thread polls the ring instead, submitting then costs no syscall at
+ * all until the poller went to sleep and asks for a wakeup.
+ *
+ * Operations run in order, a blocking one delays the ones behind it.
+ * IPC is not offered: its message lives in the caller's registers.
+ */
+#define URING_ENTRIES 32 // power of two
+
+#define URING_SETUP_SQPOLL (1u << 0)
+#define URING_NEED_WAKEUP  (1u << 0) // set by the poller before it sleeps
+
+enum uring_op {
+	URING_OP_NOP,
+	URING_OP_WRITE,	     // arg0 = buf, arg1 = len
+	URING_OP_READ,	     // arg0 = buf, arg1 = len, waits for every character
+	URING_OP_SLEEP,	     // arg0 = ticks
+	URING_OP_FUTEX_WAKE, // arg0 = addr, arg1 = count
+};
+
+struct uring_sqe {
+	uint32_t op;
+	uint32_t arg0;
+	uint32_t arg1;
+	uint32_t user_data; // copied into the completion
+};
+
+struct uring_cqe {
+	uint32_t user_data;
+	int32_t	 result;
+};
+
+struct uring {
+	volatile uint32_t sq_head; // advanced by the kernel
+	volatile uint32_t sq_tail; // advanced by user code
+	volatile uint32_t cq_head; // advanced by user code
+	volatile uint32_t cq_tail; // advanced by the kernel
+	volatile uint32_t flags;
+	uint32_t	  sqe_tail; // user side: entries handed out, up to the next submit
+	int32_t		  id;
+	bool		  sqpoll;
+	struct uring_sqe  sq[URING_ENTRIES];
+	struct uring_cqe  cq[URING_ENTRIES];
+};
+
+/* Registers ring with the kernel, returns -1 if no slot is left */
+int uring_setup(struct uring *ring, uint32_t flags);
+
+/* Next free submission entry, nullptr while the ring is full */
+struct uring_sqe *uring_get_sqe(struct uring *ring);
+
+/* Passes the queued entries to the kernel, a syscall only if needed */
+void uring_submit(struct uring *ring);
+
+/* Like uring_submit, then blocks until count completions are ready */
+void uring_submit_and_wait(struct uring *ring, uint32_t count);
+
+/* Oldest completion not yet seen, nullptr if there is none */
+struct uring_cqe *uring_peek_cqe(struct uring *ring);
+void		  uring_cqe_seen(struct uring *ring);
+
+#endif
@@ -0,0 +1,50 @@
+#include <kernel/debug.h>
+#include <kernel/futex.h>
+#include <kernel/hrtimer.h>
+#include <kernel/input_pool.h>
+#include <kernel/ipc.h>
+#include <kernel/irqsoff.h>
+#include <kernel/kconfig.h>
+#include <kernel/pages.h>
+#include <kernel/poll.h>
+#include <kernel/profile.h>
+#include <kernel/uring.h>
+#include <arch/bsp/irq_controller.h>
+#include <arch/bsp/uart.h>
+#include <arch/cpu/scheduler.h>
+
+static void print_stats(void)
+{
+	irq_controller_print_stats();
+	uart_print_stats();
+	input_print_stats();
+	hrtimer_print_stats();
+	sched_rt_print_stats();
+	scheduler_print_stats();
+	futex_print_stats();
+	ipc_print_stats();
+	pages_print_stats();
+	uring_print_stats();
+	poll_print_stats();
+}
+
+bool debug_key(char c)
+{
+	if (!UART_DEBUG_KEYS) {
+		return false;
+	}
+
+	switch (c) {
+	case 'I':
+		print_stats();
+		return true;
+	case 'R':
+		profile_dump();
+		return true;
+	case 'T':
+		irqsoff_dump();
+		return true;
+	default:
+		return false;
+	}
+}
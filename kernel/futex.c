@@ -0,0 +1,270 @@
+#include <kernel/futex.h>
+#include <kernel/wait.h>
+#include <arch/cpu/irq_flags.h>
+#include <arch/cpu/scheduler.h>
+#include <lib/kprintf.h>
+
+#define FUTEX_BUCKETS 16
+
+static wait_queue_t buckets[FUTEX_BUCKETS];
+
+static uint32_t wait_calls   = 0;
+static uint32_t wake_calls   = 0;
+static uint32_t lock_calls   = 0;
+static uint32_t unlock_calls = 0;
+
+static bool time_before(uint32_t a, uint32_t b)
+{
+	return (int32_t)(a - b) < 0;
+}
+
+static wait_queue_t *bucket_of(volatile uint32_t *addr)
+{
+	return &buckets[((uint32_t)addr >> 2) % FUTEX_BUCKETS];
+}
+
+static void sleep_on(volatile uint32_t *addr, bool pi)
+{
+	tcb_t *current = scheduler_get_current_thread();
+
+	current->futex_addr = addr;
+	current->futex_pi   = pi;
+	wait_queue_sleep(bucket_of(addr));
+	current->futex_addr = nullptr;
+}
+
+static void wake_thread(tcb_t *thread)
+{
+	list_remove(&bucket_of(thread->futex_addr)->head, &thread->wait_node);
+	scheduler_wake(thread);
+}
+
+/* Waiter on addr with the earliest deadline, the longest waiting one on ties */
+static tcb_t *top_waiter(volatile uint32_t *addr, tcb_t *skip)
+{
+	wait_queue_t *wq	    = bucket_of(addr);
+	tcb_t	     *best	    = nullptr;
+	bool	      best_has	    = false;
+	uint32_t      best_deadline = 0;
+
+	for (list_node *curr = wq->head.next; curr != &wq->head; curr = curr->next) {
+		tcb_t	*thread = list_entry(curr, tcb_t, wait_node);
+		uint32_t deadline;
+
+		if (thread->futex_addr != addr || thread == skip) {
+			continue;
+		}
+
+		bool has = sched_rt_deadline(thread, &deadline);
+		if (!best || (has && (!best_has || time_before(deadline, best_deadline)))) {
+			best	      = thread;
+			best_has      = has;
+			best_deadline = deadline;
+		}
+	}
+
+	return best;
+}
+
+/* A thread that exited holding the mutex owns it no longer */
+static tcb_t *owner_of(volatile uint32_t *addr)
+{
+	uint32_t tid	= *addr & FUTEX_TID_MASK;
+	tcb_t	*thread = tid ? scheduler_get_thread((int)tid) : nullptr;
+
+	if (!thread || thread->state == THREAD_STATE_TERMINATED) {
+		return nullptr;
+	}
+	return thread;
+}
+
+/* Passes the deadline of waiter down the chain of mutex owners */
+static void pi_propagate(tcb_t *waiter, tcb_t *owner)
+{
+	uint32_t deadline;
+
+	if (!sched_rt_deadline(waiter, &deadline)) {
+		return;
+	}
+
+	for (unsigned int depth = 0; owner && depth < MAX_THREADS; depth++) {
+		uint32_t owner_deadline;
+		if (sched_rt_deadline(owner, &owner_deadline) &&
+		    !time_before(deadline, owner_deadline)) {
+			return;
+		}
+		scheduler_pi_boost(owner, deadline);
+
+		if (!owner->futex_addr || !owner->futex_pi) {
+			return;
+		}
+		owner = owner_of(owner->futex_addr);
+	}
+}
+
+/* Boost of owner from the waiters of all PI mutexes it still holds */
+static void pi_recompute(tcb_t *owner)
+{
+	bool	 boosted = false;
+	uint32_t best	 = 0;
+
+	scheduler_pi_unboost(owner);
+
+	for (unsigned int i = 0; i < FUTEX_BUCKETS; i++) {
+		list_node *head = &buckets[i].head;
+		for (list_node *curr = head->next; curr != head; curr = curr->next) {
+			tcb_t	*thread = list_entry(curr, tcb_t, wait_node);
+			uint32_t deadline;
+
+			if (!thread->futex_pi || owner_of(thread->futex_addr) != owner) {
+				continue;
+			}
+			if (sched_rt_deadline(thread, &deadline) &&
+			    (!boosted || time_before(deadline, best))) {
+				boosted = true;
+				best	= deadline;
+			}
+		}
+	}
+
+	if (boosted) {
+		scheduler_pi_boost(owner, best);
+	}
+}
+
+/* Passes the PI mutex at addr to its top waiter, unlocks it if there is none */
+static void hand_over(volatile uint32_t *addr)
+{
+	tcb_t *next = top_waiter(addr, nullptr);
+	if (!next) {
+		*addr = 0;
+		return;
+	}
+
+	tcb_t *other = top_waiter(addr, next);
+	*addr	     = next->thread_id | (other ? FUTEX_WAITERS : 0);
+	wake_thread(next);
+	if (other) {
+		pi_propagate(other, next);
+	}
+}
+
+/* A thread blocked on a PI mutex that owner holds */
+static tcb_t *pi_waiter_of(tcb_t *owner)
+{
+	for (unsigned int i = 0; i < FUTEX_BUCKETS; i++) {
+		list_node *head = &buckets[i].head;
+		for (list_node *curr = head->next; curr != head; curr = curr->next) {
+			tcb_t *thread = list_entry(curr, tcb_t, wait_node);
+			if (thread->futex_pi && owner_of(thread->futex_addr) == owner) {
+				return thread;
+			}
+		}
+	}
+	return nullptr;
+}
+
+void futex_init(void)
+{
+	for (unsigned int i = 0; i < FUTEX_BUCKETS; i++) {
+		wait_queue_init(&buckets[i]);
+	}
+}
+
+int futex_wait(volatile uint32_t *addr, uint32_t expected)
+{
+	uint32_t flags = local_irq_save();
+	wait_calls++;
+
+	if (*addr != expected) {
+		local_irq_restore(flags);
+		return -1;
+	}
+	sleep_on(addr, false);
+
+	local_irq_restore(flags);
+	return 0;
+}
+
+int futex_wake(volatile uint32_t *addr, uint32_t count)
+{
+	uint32_t flags = local_irq_save();
+	int	 woken = 0;
+	wake_calls++;
+
+	wait_queue_t *wq   = bucket_of(addr);
+	list_node    *curr = wq->head.next;
+	while (curr != &wq->head && (uint32_t)woken < count) {
+		tcb_t *thread = list_entry(curr, tcb_t, wait_node);
+		curr	      = curr->next;
+
+		if (thread->futex_addr == addr) {
+			wake_thread(thread);
+			woken++;
+		}
+	}
+
+	local_irq_restore(flags);
+	return woken;
+}
+
+int futex_lock_pi(volatile uint32_t *addr)
+{
+	tcb_t	*current = scheduler_get_current_thread();
+	uint32_t flags	 = local_irq_save();
+	lock_calls++;
+
+	while (true) {
+		uint32_t val = *addr;
+		tcb_t	*owner = owner_of(addr);
+
+		// Handed over by futex_unlock_pi
+		if (owner == current) {
+			break;
+		}
+		if (!owner) {
+			*addr = current->thread_id | (val & FUTEX_WAITERS);
+			break;
+		}
+
+		*addr = val | FUTEX_WAITERS;
+		pi_propagate(current, owner);
+		sleep_on(addr, true);
+	}
+
+	local_irq_restore(flags);
+	return 0;
+}
+
+int futex_unlock_pi(volatile uint32_t *addr)
+{
+	tcb_t	*current = scheduler_get_current_thread();
+	uint32_t flags	 = local_irq_save();
+	unlock_calls++;
+
+	if (owner_of(addr) != current) {
+		local_irq_restore(flags);
+		return -1;
+	}
+
+	hand_over(addr);
+	pi_recompute(current);
+
+	local_irq_restore(flags);
+	return 0;
+}
+
+void futex_thread_exit(tcb_t *thread)
+{
+	tcb_t *waiter;
+
+	while ((waiter = pi_waiter_of(thread))) {
+		hand_over(waiter->futex_addr);
+	}
+}
+
+void futex_print_stats(void)
+{
+	kprintf("futex: %u wait, %u wake, %u lock_pi, %u unlock_pi\n", wait_calls, wake_calls,
+		lock_calls, unlock_calls);
+}
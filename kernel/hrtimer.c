@@ -0,0 +1,174 @@
+#include <kernel/hrtimer.h>
+#include <arch/bsp/irq_controller.h>
+#include <arch/bsp/systimer.h>
+#include <arch/cpu/irq_flags.h>
+#include <lib/kprintf.h>
+
+// Closest a deadline is programmed to now, so the compare cannot pass while it is set
+#define HRTIMER_MIN_DELTA_US 5
+
+static list_node timer_queue = { &timer_queue, &timer_queue };
+
+static uint32_t expirations_total = 0;
+static uint32_t jitter_total	  = 0;
+static uint32_t jitter_max	  = 0;
+static uint32_t missed_periods	  = 0;
+
+static bool time_before(uint32_t a, uint32_t b)
+{
+	return (int32_t)(a - b) < 0;
+}
+
+/* Keeps the queue ordered by deadline, equal deadlines fire in start order */
+static void enqueue(struct hrtimer *timer)
+{
+	list_node *curr;
+	for (curr = timer_queue.next; curr != &timer_queue; curr = curr->next) {
+		if (time_before(timer->expires, list_entry(curr, struct hrtimer, node)->expires)) {
+			break;
+		}
+	}
+	list_add_(&timer->node, curr->prev);
+	timer->active = true;
+}
+
+/*
+ * Programs C3 for the earliest deadline. The compare only matches on
+ * equality, so a deadline that passes while programming would be missed
+ * for a whole counter wrap; report it to the caller instead.
+ */
+static bool program_next(void)
+{
+	list_node *first = list_get_first(&timer_queue);
+	if (!first) {
+		return true;
+	}
+
+	uint32_t expires = list_entry(first, struct hrtimer, node)->expires;
+	systimer_c3_arm(expires);
+	return time_before(systimer_now(), expires);
+}
+
+/*
+ * Programs C3 like program_next, but a deadline that is due or too close
+ * is moved to HRTIMER_MIN_DELTA_US from now, so its callback runs from
+ * the IRQ and never in the caller.
+ */
+static void program_next_from_irq(void)
+{
+	list_node *first = list_get_first(&timer_queue);
+	if (!first) {
+		return;
+	}
+
+	uint32_t expires = list_entry(first, struct hrtimer, node)->expires;
+	do {
+		uint32_t earliest = systimer_now() + HRTIMER_MIN_DELTA_US;
+		if (time_before(expires, earliest)) {
+			expires = earliest;
+		}
+		systimer_c3_arm(expires);
+	} while (!time_before(systimer_now(), expires));
+}
+
+static void run_expired(uint32_t now)
+{
+	list_node *first;
+	while ((first = list_get_first(&timer_queue))) {
+		struct hrtimer *timer = list_entry(first, struct hrtimer, node);
+		if (time_before(now, timer->expires)) {
+			break;
+		}
+
+		list_remove_first(&timer_queue);
+		timer->active = false;
+
+		uint32_t jitter = now - timer->expires;
+		timer->expirations++;
+		if (jitter > timer->jitter_max) {
+			timer->jitter_max = jitter;
+		}
+		expirations_total++;
+		jitter_total += jitter;
+		if (jitter > jitter_max) {
+			jitter_max = jitter;
+		}
+
+		if (timer->period) {
+			// Next deadline relative to the last one, not to now
+			timer->expires += timer->period;
+			while (!time_before(now, timer->expires)) {
+				timer->expires += timer->period;
+				missed_periods++;
+			}
+			enqueue(timer);
+		}
+
+		timer->func(timer);
+	}
+}
+
+static void hrtimer_irq_handler(void *ctx)
+{
+	(void)ctx;
+	systimer_c3_ack();
+
+	do {
+		run_expired(systimer_now());
+	} while (!program_next());
+}
+
+void hrtimer_init(void)
+{
+	request_irq(IRQ_SYSTIMER_3, hrtimer_irq_handler, nullptr);
+}
+
+void hrtimer_start(struct hrtimer *timer, uint32_t delay_us, uint32_t period_us)
+{
+	uint32_t flags = local_irq_save();
+
+	if (timer->active) {
+		list_remove(&timer_queue, &timer->node);
+	}
+	timer->expires = systimer_now() + delay_us;
+	timer->period  = period_us;
+	enqueue(timer);
+	program_next_from_irq();
+
+	local_irq_restore(flags);
+}
+
+void hrtimer_cancel(struct hrtimer *timer)
+{
+	uint32_t flags = local_irq_save();
+
+	if (timer->active) {
+		list_remove(&timer_queue, &timer->node);
+		timer->active = false;
+	}
+
+	local_irq_restore(flags);
+}
+
+void hrtimer_print_stats(void)
+{
+	uint32_t flags = local_irq_save();
+	uint32_t count = expirations_total;
+	uint32_t total = jitter_total;
+	uint32_t max   = jitter_max;
+	uint32_t missed = missed_periods;
+	local_irq_restore(flags);
+
+	kprintf("hrtimer: %u expirations, jitter avg %u us max %u us, %u missed periods\n", count,
+		count ? total / count : 0, max, missed);
+}
+
+void hrtimer_reset_stats(void)
+{
+	uint32_t flags = local_irq_save();
+	expirations_total = 0;
+	jitter_total	  = 0;
+	jitter_max	  = 0;
+	missed_periods	  = 0;
+	local_irq_restore(flags);
+}
@@ -0,0 +1,155 @@
+#include <kernel/input_pool.h>
+#include <kernel/kconfig.h>
+#include <kernel/wait.h>
+#include <arch/bsp/systimer.h>
+#include <arch/cpu/irq_flags.h>
+#include <arch/cpu/scheduler.h>
+#include <lib/kprintf.h>
+#include <lib/ringbuffer.h>
+#include <user/input.h>
+#include <user/main.h>
+
+create_ringbuffer(input_events, INPUT_EVENT_QUEUE_SIZE);
+static wait_queue_t input_wait = WAIT_QUEUE_INIT(input_wait);
+
+// Rates are counted over fixed windows that start at the first event of a burst
+#define RATE_WINDOW_US 1000000
+
+static uint32_t events_processed = 0;
+static uint32_t events_dropped	 = 0;
+static uint32_t window_start	 = 0;
+static uint32_t window_events	 = 0;
+static uint32_t rate_last	 = 0;
+static uint32_t rate_peak	 = 0;
+
+// Queue time of every queued event, same order as input_events
+static uint32_t post_times[INPUT_EVENT_QUEUE_SIZE];
+static uint32_t events_queued	= 0;
+static uint32_t latency_max	= 0;
+static uint32_t latency_total	= 0;
+
+/* Closes the rate window once it is over, called with IRQs off */
+static void rate_window_close(uint32_t now)
+{
+	if (!window_events || now - window_start < RATE_WINDOW_US) {
+		return;
+	}
+
+	rate_last = window_events * (1000000 / RATE_WINDOW_US);
+	if (rate_last > rate_peak) {
+		rate_peak = rate_last;
+	}
+	window_events = 0;
+}
+
+/* Counts one event handed to main(), called with IRQs off */
+static void rate_account(void)
+{
+	uint32_t now = systimer_now();
+
+	rate_window_close(now);
+	if (!window_events) {
+		window_start = now;
+	}
+	window_events++;
+	events_processed++;
+}
+
+static void input_worker_exit(tcb_t *thread);
+
+static void input_worker_spawn(void)
+{
+	int tid = scheduler_thread_create(input_worker, nullptr, 0);
+	if (tid >= 0) {
+		scheduler_set_exit_hook(tid, input_worker_exit);
+	}
+}
+
+/* Keeps the pool at full size if main() ended a worker */
+static void input_worker_exit(tcb_t *thread)
+{
+	(void)thread;
+	input_worker_spawn();
+}
+
+void input_pool_init(void)
+{
+	if (!INPUT_THREAD_POOL) {
+		return;
+	}
+
+	for (unsigned int i = 0; i < INPUT_POOL_WORKERS; i++) {
+		input_worker_spawn();
+	}
+}
+
+void input_event_post(char c)
+{
+	uint32_t flags = local_irq_save();
+
+	if (!INPUT_THREAD_POOL) {
+		// Pass address of c directly - scheduler_thread_create will copy it
+		if (scheduler_thread_create(main, &c, sizeof(c)) < 0) {
+			events_dropped++;
+		} else {
+			rate_account();
+		}
+		local_irq_restore(flags);
+		return;
+	}
+
+	if (buff_putc(input_events, c)) {
+		events_dropped++;
+	} else {
+		post_times[events_queued++ % INPUT_EVENT_QUEUE_SIZE] = systimer_now();
+		wake_up_one(&input_wait);
+	}
+	local_irq_restore(flags);
+}
+
+char input_pool_take(void)
+{
+	uint32_t flags = local_irq_save();
+
+	while (buff_is_empty(input_events)) {
+		wait_queue_sleep(&input_wait);
+	}
+	char c = buff_getc(input_events);
+
+	// Time until a worker got the event, i.e. the keystroke latency
+	uint32_t latency = systimer_now() - post_times[events_processed % INPUT_EVENT_QUEUE_SIZE];
+	rate_account();
+	latency_total += latency;
+	if (latency > latency_max) {
+		latency_max = latency;
+	}
+
+	local_irq_restore(flags);
+	return c;
+}
+
+void input_get_stats(struct input_stats *stats)
+{
+	uint32_t flags = local_irq_save();
+
+	rate_window_close(systimer_now());
+	stats->processed = events_processed;
+	stats->dropped	 = events_dropped;
+	stats->rate_last = rate_last;
+	stats->rate_peak = rate_peak;
+	local_irq_restore(flags);
+}
+
+void input_print_stats(void)
+{
+	struct input_stats stats;
+	input_get_stats(&stats);
+
+	kprintf("input via %s: processed %u, dropped %u, %u chars/s last burst, %u peak\n",
+		INPUT_THREAD_POOL ? "thread pool" : "thread per char", stats.processed,
+		stats.dropped, stats.rate_last, stats.rate_peak);
+	if (INPUT_THREAD_POOL && events_processed) {
+		kprintf("input latency: avg %u us, max %u us\n", latency_total / events_processed,
+			latency_max);
+	}
+}
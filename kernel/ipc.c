@@ -0,0 +1,232 @@
+#include <kernel/ipc.h>
+#include <kernel/poll.h>
+#include <arch/cpu/irq_flags.h>
+#include <arch/cpu/scheduler.h>
+#include <lib/kprintf.h>
+
+static uint32_t direct_switches = 0;
+static uint32_t queued_sends	= 0;
+static uint32_t replies		= 0;
+static uint32_t failures	= 0;
+
+void ipc_thread_init(tcb_t *thread)
+{
+	thread->ipc.state   = IPC_NONE;
+	thread->ipc.partner = 0;
+	list_init(&thread->ipc.senders);
+}
+
+static void copy_msg(exc_frame_t *to, const exc_frame_t *from)
+{
+	to->r1 = from->r1;
+	to->r2 = from->r2;
+	to->r3 = from->r3;
+	to->r4 = from->r4;
+	to->r5 = from->r5;
+	to->r6 = from->r6;
+}
+
+/*
+ * Live user thread with id tid, other than the current one. The idle
+ * thread and kernel threads never receive, a sender would wait forever.
+ */
+static tcb_t *partner_of(uint32_t tid)
+{
+	tcb_t *thread = scheduler_get_thread((int)tid);
+
+	if (!thread || tid == IDLE_THREAD_ID || thread == scheduler_get_current_thread() ||
+	    thread->state == THREAD_STATE_TERMINATED || !scheduler_is_user_thread(thread)) {
+		return nullptr;
+	}
+	return thread;
+}
+
+static bool accepts(const tcb_t *receiver, const tcb_t *sender)
+{
+	return receiver->ipc.state == IPC_RECV_WAIT &&
+	       (receiver->ipc.partner == IPC_ANY || receiver->ipc.partner == sender->thread_id);
+}
+
+/* Oldest thread queued sending to receiver that matches from */
+static tcb_t *first_sender(tcb_t *receiver, uint32_t from)
+{
+	list_node *head = &receiver->ipc.senders;
+
+	for (list_node *curr = head->next; curr != head; curr = curr->next) {
+		tcb_t *sender = list_entry(curr, tcb_t, wait_node);
+		if (from == IPC_ANY || from == sender->thread_id) {
+			return sender;
+		}
+	}
+	return nullptr;
+}
+
+/* Completes the IPC operation thread is blocked in with result r0 */
+static void finish(tcb_t *thread, uint32_t r0)
+{
+	thread->ipc.state = IPC_NONE;
+	thread->frame->r0 = r0;
+	scheduler_wake(thread);
+}
+
+static void send(tcb_t *current, exc_frame_t *frame, bool call)
+{
+	tcb_t *dest = partner_of(frame->r0);
+
+	if (!dest) {
+		failures++;
+		frame->r0 = (uint32_t)-1;
+		return;
+	}
+
+	frame->r0 = 0;
+	if (!accepts(dest, current)) {
+		/* The receiver picks up the message from our frame later */
+		current->ipc.state   = call ? IPC_CALL_SEND : IPC_SEND_WAIT;
+		current->ipc.partner = dest->thread_id;
+		list_add_last(&dest->ipc.senders, &current->wait_node);
+		queued_sends++;
+		poll_notify();
+		scheduler_block_current();
+		return;
+	}
+
+	copy_msg(dest->frame, frame);
+	dest->frame->r0	  = current->thread_id;
+	dest->ipc.state	  = IPC_NONE;
+	dest->ipc.partner = current->thread_id;
+	if (call) {
+		current->ipc.state   = IPC_CALL_WAIT;
+		current->ipc.partner = dest->thread_id;
+		current->state	     = THREAD_STATE_BLOCKED;
+	}
+	if (scheduler_handoff(dest)) {
+		direct_switches++;
+	}
+}
+
+static void receive(tcb_t *current, exc_frame_t *frame, uint32_t from)
+{
+	tcb_t *sender = first_sender(current, from);
+
+	if (!sender) {
+		current->ipc.state   = IPC_RECV_WAIT;
+		current->ipc.partner = from;
+		scheduler_block_current();
+		return;
+	}
+
+	list_remove(&current->ipc.senders, &sender->wait_node);
+	copy_msg(frame, sender->frame);
+	frame->r0	     = sender->thread_id;
+	current->ipc.partner = sender->thread_id;
+	if (sender->ipc.state == IPC_CALL_SEND) {
+		sender->ipc.state = IPC_CALL_WAIT;
+	} else {
+		finish(sender, 0);
+	}
+}
+
+/* Hands the reply in the current frame to client, nullptr if it does not wait for one */
+static tcb_t *reply(tcb_t *current, exc_frame_t *frame)
+{
+	tcb_t *client = partner_of(frame->r0);
+
+	if (!client || client->ipc.state != IPC_CALL_WAIT ||
+	    client->ipc.partner != current->thread_id) {
+		failures++;
+		return nullptr;
+	}
+
+	copy_msg(client->frame, frame);
+	client->frame->r0 = 0;
+	client->ipc.state = IPC_NONE;
+	replies++;
+	return client;
+}
+
+void ipc_handle_send(exc_frame_t *frame)
+{
+	uint32_t flags = local_irq_save();
+	send(scheduler_get_current_thread(), frame, false);
+	local_irq_restore(flags);
+}
+
+void ipc_handle_call(exc_frame_t *frame)
+{
+	uint32_t flags = local_irq_save();
+	send(scheduler_get_current_thread(), frame, true);
+	local_irq_restore(flags);
+}
+
+void ipc_handle_receive(exc_frame_t *frame)
+{
+	uint32_t flags = local_irq_save();
+	receive(scheduler_get_current_thread(), frame, frame->r0);
+	local_irq_restore(flags);
+}
+
+void ipc_handle_reply(exc_frame_t *frame)
+{
+	uint32_t flags	= local_irq_save();
+	tcb_t	*client = reply(scheduler_get_current_thread(), frame);
+
+	frame->r0 = client ? 0 : (uint32_t)-1;
+	if (client) {
+		scheduler_wake(client);
+	}
+	local_irq_restore(flags);
+}
+
+/*
+ * The server side of a call round trip. When no other client is queued
+ * the server blocks in receive and switches straight back to the client.
+ */
+void ipc_handle_reply_receive(exc_frame_t *frame)
+{
+	uint32_t flags	 = local_irq_save();
+	tcb_t	*current = scheduler_get_current_thread();
+	tcb_t	*client	 = reply(current, frame);
+	uint32_t from	 = frame->r7;
+
+	if (client && !first_sender(current, from)) {
+		current->ipc.state   = IPC_RECV_WAIT;
+		current->ipc.partner = from;
+		current->state	     = THREAD_STATE_BLOCKED;
+		if (scheduler_handoff(client)) {
+			direct_switches++;
+		}
+	} else {
+		if (client) {
+			scheduler_wake(client);
+		}
+		receive(current, frame, from);
+	}
+	local_irq_restore(flags);
+}
+
+void ipc_thread_exit(tcb_t *thread)
+{
+	list_node *node;
+
+	while ((node = list_remove_first(&thread->ipc.senders))) {
+		finish(list_entry(node, tcb_t, wait_node), (uint32_t)-1);
+	}
+
+	for (int tid = 0; tid < MAX_THREADS; tid++) {
+		tcb_t *other = scheduler_get_thread(tid);
+		if (other->ipc.partner != thread->thread_id) {
+			continue;
+		}
+		if (other->ipc.state == IPC_CALL_WAIT || other->ipc.state == IPC_RECV_WAIT) {
+			finish(other, (uint32_t)-1);
+		}
+	}
+	thread->ipc.state = IPC_NONE;
+}
+
+void ipc_print_stats(void)
+{
+	kprintf("ipc: %u direct switches, %u queued sends, %u replies, %u failed\n",
+		direct_switches, queued_sends, replies, failures);
+}
@@ -0,0 +1,99 @@
+#include <kernel/irqsoff.h>
+#include <kernel/kconfig.h>
+#include <arch/cpu/irq_flags.h>
+#include <arch/cpu/pmu.h>
+#include <lib/kprintf.h>
+#include <lib/mem.h>
+
+struct irqsoff_window {
+	uint32_t start_site;
+	uint32_t end_site;
+	uint32_t max_cycles;
+	uint32_t hits;
+};
+
+// Sorted by max_cycles, longest first
+static struct irqsoff_window top[IRQSOFF_TOP];
+static unsigned int	     top_count = 0;
+
+static uint32_t start_cycles = 0;
+static uint32_t start_site   = 0;
+static uint32_t windows	     = 0;
+
+/* Moves entry i up while it is longer than its predecessor */
+static void sift_up(unsigned int i)
+{
+	while (i > 0 && top[i].max_cycles > top[i - 1].max_cycles) {
+		struct irqsoff_window tmp = top[i - 1];
+		top[i - 1]		  = top[i];
+		top[i]			  = tmp;
+		i--;
+	}
+}
+
+static void record(uint32_t end_site, uint32_t cycles)
+{
+	for (unsigned int i = 0; i < top_count; i++) {
+		if (top[i].start_site == start_site && top[i].end_site == end_site) {
+			top[i].hits++;
+			if (cycles > top[i].max_cycles) {
+				top[i].max_cycles = cycles;
+				sift_up(i);
+			}
+			return;
+		}
+	}
+
+	unsigned int i;
+	if (top_count < IRQSOFF_TOP) {
+		i = top_count++;
+	} else if (cycles > top[IRQSOFF_TOP - 1].max_cycles) {
+		i = IRQSOFF_TOP - 1;
+	} else {
+		return;
+	}
+	top[i] = (struct irqsoff_window){ start_site, end_site, cycles, 1 };
+	sift_up(i);
+}
+
+void irqsoff_begin(uint32_t site)
+{
+	start_site   = site;
+	start_cycles = pmu_cycles();
+}
+
+void irqsoff_end(uint32_t site)
+{
+	uint32_t cycles = pmu_cycles() - start_cycles;
+
+	// No open window, e.g. the second exit after a thread switch
+	if (!start_site) {
+		return;
+	}
+	record(site, cycles);
+	windows++;
+	start_site = 0;
+}
+
+void irqsoff_dump(void)
+{
+	struct irqsoff_window copy[IRQSOFF_TOP];
+
+	uint32_t     flags = local_irq_save();
+	unsigned int count = top_count;
+	uint32_t     total = windows;
+	memcpy(copy, top, sizeof(copy));
+	top_count = 0;
+	windows	  = 0;
+	local_irq_restore(flags);
+
+	if (!IRQSOFF_TRACER) {
+		kprintf("irqsoff: tracer disabled, set IRQSOFF_TRACER in kernel/kconfig.h\n");
+		return;
+	}
+	kprintf("irqsoff: %u windows, longest %u:\n", total, count);
+	for (unsigned int i = 0; i < count; i++) {
+		kprintf("irqsoff cycles=%u hits=%u start=%08x end=%08x\n", copy[i].max_cycles,
+			copy[i].hits, copy[i].start_site, copy[i].end_site);
+	}
+}
@@ -0,0 +1,43 @@
+#include <kernel/pages.h>
+#include <kernel/kconfig.h>
+#include <arch/cpu/irq_flags.h>
+#include <lib/kprintf.h>
+#include <lib/mem.h>
+
+static uint32_t heap_break  = USER_HEAP_BASE;
+static uint32_t pages_max   = 0;
+static uint32_t sbrk_calls  = 0;
+static uint32_t sbrk_failed = 0;
+
+void *pages_sbrk(int32_t pages)
+{
+	uint32_t flags	   = local_irq_save();
+	uint32_t old_break = heap_break;
+	uint32_t new_break = old_break + (uint32_t)(pages * PAGE_SIZE);
+
+	sbrk_calls++;
+	if (new_break < USER_HEAP_BASE || new_break > USER_HEAP_BASE + USER_HEAP_SIZE ||
+	    (pages > 0 && new_break < old_break)) {
+		sbrk_failed++;
+		local_irq_restore(flags);
+		return nullptr;
+	}
+
+	heap_break = new_break;
+	uint32_t used = (heap_break - USER_HEAP_BASE) / PAGE_SIZE;
+	if (used > pages_max) {
+		pages_max = used;
+	}
+	local_irq_restore(flags);
+
+	if (pages > 0) {
+		memset((void *)old_break, 0, new_break - old_break);
+	}
+	return (void *)old_break;
+}
+
+void pages_print_stats(void)
+{
+	kprintf("heap pages: %u in use, %u max, %u sbrk calls, %u failed\n",
+		(heap_break - USER_HEAP_BASE) / PAGE_SIZE, pages_max, sbrk_calls, sbrk_failed);
+}
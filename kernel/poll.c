@@ -0,0 +1,106 @@
+#include <kernel/poll.h>
+#include <kernel/hrtimer.h>
+#include <kernel/kconfig.h>
+#include <kernel/wait.h>
+#include <arch/bsp/uart.h>
+#include <arch/cpu/scheduler.h>
+#include <lib/kprintf.h>
+
+// With RX on the FIQ there is no TX interrupt, POLL_UART_OUT is re-checked this often
+#define TX_RECHECK_US 200
+
+struct poll_timeout {
+	struct hrtimer timer;
+	volatile bool  expired;
+};
+
+static wait_queue_t poll_queue = WAIT_QUEUE_INIT(poll_queue);
+
+static uint32_t poll_calls  = 0;
+static uint32_t poll_sleeps = 0;
+static uint32_t poll_checks = 0; // checks after a wake up, spurious ones included
+
+static void timeout_func(struct hrtimer *timer)
+{
+	struct poll_timeout *timeout = list_entry(timer, struct poll_timeout, timer);
+
+	timeout->expired = true;
+	poll_notify();
+}
+
+static void tx_recheck_func(struct hrtimer *timer)
+{
+	(void)timer;
+	poll_notify();
+}
+
+static uint32_t ready_set(uint32_t events)
+{
+	uint32_t ready = 0;
+
+	if ((events & POLL_UART_IN) && uart_data_available()) {
+		ready |= POLL_UART_IN;
+	}
+	if ((events & POLL_UART_OUT) && uart_tx_ready()) {
+		ready |= POLL_UART_OUT;
+	}
+	if ((events & POLL_IPC) &&
+	    !list_is_empty(&scheduler_get_current_thread()->ipc.senders)) {
+		ready |= POLL_IPC;
+	}
+	return ready;
+}
+
+/* Called with IRQs disabled by wait_event, arms the TX interrupt if needed */
+static bool check(uint32_t events, const struct poll_timeout *timeout, uint32_t *ready)
+{
+	poll_checks++;
+	*ready = ready_set(events);
+	if (*ready) {
+		return true;
+	}
+	if (timeout->expired) {
+		*ready = POLL_TIMEOUT;
+		return true;
+	}
+	if (events & POLL_UART_OUT) {
+		uart_tx_notify_enable();
+	}
+	return false;
+}
+
+uint32_t poll_wait(uint32_t events, uint32_t timeout_us)
+{
+	struct poll_timeout timeout = { .timer = HRTIMER_INIT(timeout_func), .expired = false };
+	struct hrtimer	    recheck = HRTIMER_INIT(tx_recheck_func);
+	uint32_t	    ready   = ready_set(events);
+
+	poll_calls++;
+	if (ready || timeout_us == 0) {
+		return ready ? ready : POLL_TIMEOUT;
+	}
+
+	poll_sleeps++;
+	if (timeout_us != POLL_FOREVER) {
+		hrtimer_start(&timeout.timer, timeout_us, 0);
+	}
+	if (UART_RX_FIQ && (events & POLL_UART_OUT)) {
+		hrtimer_start(&recheck, TX_RECHECK_US, TX_RECHECK_US);
+	}
+	wait_event(&poll_queue, check(events, &timeout, &ready));
+	hrtimer_cancel(&recheck);
+	hrtimer_cancel(&timeout.timer);
+
+	return ready;
+}
+
+void poll_notify(void)
+{
+	wake_up(&poll_queue);
+}
+
+void poll_print_stats(void)
+{
+	kprintf("poll: %u calls, %u slept, %u checks after wake ups\n", poll_calls, poll_sleeps,
+		poll_checks - poll_sleeps);
+}
@@ -0,0 +1,111 @@
+#include <kernel/profile.h>
+#include <kernel/kconfig.h>
+#include <arch/bsp/irq_controller.h>
+#include <arch/cpu/generic_timer.h>
+#include <arch/cpu/interrupts.h>
+#include <arch/cpu/irq_flags.h>
+#include <arch/cpu/psr.h>
+#include <arch/cpu/scheduler.h>
+#include <lib/kprintf.h>
+
+struct profile_sample {
+	uint32_t pc;
+	uint32_t lr; // caller while the interrupted function has not reused lr
+	uint8_t	 tid;
+	uint8_t	 mode;
+};
+
+static struct profile_sample samples[PROFILE_SAMPLES];
+static unsigned int	     sample_count = 0;
+static uint32_t		     dropped	  = 0; // samples after the buffer was full
+static uint64_t		     interval	  = 0; // in counts
+static bool		     running	  = false;
+
+static void profile_irq_handler(void *ctx)
+{
+	(void)ctx;
+
+	uint64_t now  = generic_timer_phys_count();
+	uint64_t cval = generic_timer_phys_get_cval() + interval;
+	while (cval <= now) {
+		cval += interval;
+	}
+	generic_timer_phys_set_cval(cval);
+
+	const exc_frame_t *frame = irq_get_frame();
+	if (!frame) {
+		return;
+	}
+	if (sample_count == PROFILE_SAMPLES) {
+		dropped++;
+		return;
+	}
+
+	struct profile_sample *sample = &samples[sample_count++];
+	uint32_t	       mode   = frame->spsr & PSR_MODE_MASK;
+
+	sample->pc   = frame->lr;
+	sample->lr   = mode == PSR_USR ? frame->usr_lr : frame->svc_lr;
+	sample->tid  = (uint8_t)scheduler_get_current_thread()->thread_id;
+	sample->mode = (uint8_t)mode;
+}
+
+void profile_init(void)
+{
+	interval = (uint64_t)PROFILE_PERIOD_US * generic_timer_counts_per_us_q10() >> 10;
+	request_irq(IRQ_LOCAL_CNTPNS, profile_irq_handler, nullptr);
+
+	if (PROFILE_SAMPLING) {
+		profile_start();
+	}
+}
+
+void profile_start(void)
+{
+	uint32_t flags = local_irq_save();
+
+	generic_timer_phys_set_cval(generic_timer_phys_count() + interval);
+	generic_timer_phys_set_ctl(CNTV_CTL_ENABLE);
+	running = true;
+
+	local_irq_restore(flags);
+}
+
+void profile_stop(void)
+{
+	generic_timer_phys_set_ctl(0);
+	running = false;
+}
+
+static const char *mode_name(uint8_t mode)
+{
+	switch (mode) {
+	case PSR_USR:
+		return "usr";
+	case PSR_SVC:
+		return "svc";
+	default:
+		return "other";
+	}
+}
+
+void profile_dump(void)
+{
+	bool was_running = running;
+	profile_stop();
+
+	kprintf("profile begin samples=%u dropped=%u period_us=%u\n", sample_count, dropped,
+		PROFILE_PERIOD_US);
+	for (unsigned int i = 0; i < sample_count; i++) {
+		const struct profile_sample *sample = &samples[i];
+		kprintf("profile_sample pc=%08x lr=%08x mode=%s tid=%u\n", sample->pc, sample->lr,
+			mode_name(sample->mode), sample->tid);
+	}
+	kprintf("profile end\n");
+
+	sample_count = 0;
+	dropped	     = 0;
+	if (was_running) {
+		profile_start();
+	}
+}
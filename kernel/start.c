@@ -16,13 +16,29 @@
 #include <config.h>
 #include <user/main.h>
 #include <arch/cpu/scheduler.h>
+#include <arch/cpu/pmu.h>
+#include <arch/cpu/generic_timer.h>
+#include <kernel/workqueue.h>
+#include <kernel/input_pool.h>
+#include <kernel/hrtimer.h>
+#include <kernel/futex.h>
+#include <kernel/time_page.h>
+#include <kernel/profile.h>
 #include <stdarg.h>
 void start_kernel [[noreturn]] (void);
 void start_kernel [[noreturn]] (void)
 {
+	pmu_init();
 	uart_init();
 	systimer_init();
+	generic_timer_init();
+	profile_init();
+	hrtimer_init();
+	time_page_init();
 	scheduler_init();
+	futex_init();
+	workqueue_init();
+	input_pool_init();
 	kprintf("=== Betriebssystem gestartet ===\n");
 	test_kernel();
 	scheduler_start();
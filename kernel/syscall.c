@@ -0,0 +1,186 @@
+#include <kernel/syscall.h>
+#include <user/syscall.h>
+#include <arch/bsp/uart.h>
+#include <arch/cpu/irq_flags.h>
+#include <arch/cpu/scheduler.h>
+#include <kernel/input_pool.h>
+#include <kernel/futex.h>
+#include <kernel/ipc.h>
+#include <kernel/pages.h>
+#include <kernel/time_page.h>
+#include <kernel/uring.h>
+#include <kernel/poll.h>
+#include <arch/bsp/systimer.h>
+
+typedef void (*syscall_fn)(exc_frame_t *frame);
+
+static void sys_exit_handler(exc_frame_t *frame)
+{
+	(void)frame;
+	scheduler_exit();
+}
+
+static void sys_yield_handler(exc_frame_t *frame)
+{
+	(void)frame;
+	scheduler_yield();
+}
+
+static void sys_getc_handler(exc_frame_t *frame)
+{
+	frame->r0 = (uint32_t)uart_getc();
+}
+
+static void sys_sleep_handler(exc_frame_t *frame)
+{
+	scheduler_sleep(frame->r0);
+}
+
+static void sys_write_handler(exc_frame_t *frame)
+{
+	// Keeps the buffer of one thread together on the line
+	preempt_disable();
+	uart_write((const char *)frame->r0, frame->r1);
+	preempt_enable();
+	frame->r0 = frame->r1;
+}
+
+static void sys_input_wait_handler(exc_frame_t *frame)
+{
+	frame->r0 = (uint32_t)input_pool_take();
+}
+
+static void sys_rt_set_handler(exc_frame_t *frame)
+{
+	frame->r0 = (uint32_t)sched_rt_set(scheduler_get_current_thread(), frame->r0, frame->r1,
+					   frame->r2);
+}
+
+static void sys_rt_wait_handler(exc_frame_t *frame)
+{
+	(void)frame;
+	sched_rt_wait_period();
+}
+
+static void sys_futex_wait_handler(exc_frame_t *frame)
+{
+	frame->r0 = (uint32_t)futex_wait((volatile uint32_t *)frame->r0, frame->r1);
+}
+
+static void sys_futex_wake_handler(exc_frame_t *frame)
+{
+	frame->r0 = (uint32_t)futex_wake((volatile uint32_t *)frame->r0, frame->r1);
+}
+
+static void sys_futex_lock_pi_handler(exc_frame_t *frame)
+{
+	frame->r0 = (uint32_t)futex_lock_pi((volatile uint32_t *)frame->r0);
+}
+
+static void sys_futex_unlock_pi_handler(exc_frame_t *frame)
+{
+	frame->r0 = (uint32_t)futex_unlock_pi((volatile uint32_t *)frame->r0);
+}
+
+static void sys_ipc_send_handler(exc_frame_t *frame)
+{
+	ipc_handle_send(frame);
+}
+
+static void sys_ipc_recv_handler(exc_frame_t *frame)
+{
+	ipc_handle_receive(frame);
+}
+
+static void sys_ipc_call_handler(exc_frame_t *frame)
+{
+	ipc_handle_call(frame);
+}
+
+static void sys_ipc_reply_handler(exc_frame_t *frame)
+{
+	ipc_handle_reply(frame);
+}
+
+static void sys_ipc_reply_recv_handler(exc_frame_t *frame)
+{
+	ipc_handle_reply_receive(frame);
+}
+
+static void sys_sbrk_handler(exc_frame_t *frame)
+{
+	frame->r0 = (uint32_t)pages_sbrk((int32_t)frame->r0);
+}
+
+static void sys_time_page_handler(exc_frame_t *frame)
+{
+	frame->r0 = (uint32_t)time_page_get();
+}
+
+static void sys_time_handler(exc_frame_t *frame)
+{
+	frame->r0 = systimer_now();
+}
+
+static void sys_uring_setup_handler(exc_frame_t *frame)
+{
+	frame->r0 = (uint32_t)uring_register((struct uring *)frame->r0, frame->r1);
+}
+
+static void sys_uring_enter_handler(exc_frame_t *frame)
+{
+	frame->r0 = (uint32_t)uring_enter((int)frame->r0, frame->r1);
+}
+
+static void sys_poll_handler(exc_frame_t *frame)
+{
+	frame->r0 = poll_wait(frame->r0, frame->r1);
+}
+
+static void sys_null_handler(exc_frame_t *frame)
+{
+	(void)frame;
+}
+
+static const syscall_fn syscall_table[SYSCALL_COUNT] = {
+	[SYSCALL_EXIT]	= sys_exit_handler,
+	[SYSCALL_YIELD] = sys_yield_handler,
+	[SYSCALL_GETC]	= sys_getc_handler,
+	[SYSCALL_SLEEP] = sys_sleep_handler,
+	[SYSCALL_INPUT_WAIT] = sys_input_wait_handler,
+	[SYSCALL_RT_SET] = sys_rt_set_handler,
+	[SYSCALL_RT_WAIT] = sys_rt_wait_handler,
+	[SYSCALL_FUTEX_WAIT] = sys_futex_wait_handler,
+	[SYSCALL_FUTEX_WAKE] = sys_futex_wake_handler,
+	[SYSCALL_FUTEX_LOCK_PI] = sys_futex_lock_pi_handler,
+	[SYSCALL_FUTEX_UNLOCK_PI] = sys_futex_unlock_pi_handler,
+	[SYSCALL_IPC_SEND] = sys_ipc_send_handler,
+	[SYSCALL_IPC_RECV] = sys_ipc_recv_handler,
+	[SYSCALL_IPC_CALL] = sys_ipc_call_handler,
+	[SYSCALL_IPC_REPLY] = sys_ipc_reply_handler,
+	[SYSCALL_IPC_REPLY_RECV] = sys_ipc_reply_recv_handler,
+	[SYSCALL_SBRK] = sys_sbrk_handler,
+	[SYSCALL_WRITE] = sys_write_handler,
+	[SYSCALL_TIME_PAGE] = sys_time_page_handler,
+	[SYSCALL_TIME] = sys_time_handler,
+	[SYSCALL_URING_SETUP] = sys_uring_setup_handler,
+	[SYSCALL_URING_ENTER] = sys_uring_enter_handler,
+	[SYSCALL_POLL] = sys_poll_handler,
+	[SYSCALL_NULL] = sys_null_handler,
+};
+
+bool syscall_dispatch(exc_frame_t *frame)
+{
+	uint32_t nr = *(const uint32_t *)(frame->lr - 4) & 0x00FFFFFF;
+
+	if (nr >= SYSCALL_COUNT || !syscall_table[nr]) {
+		return false;
+	}
+
+	/* Syscalls run preemptible, blocking ones sleep on wait queues */
+	local_irq_enable();
+	syscall_table[nr](frame);
+	local_irq_disable();
+
+	return true;
+}
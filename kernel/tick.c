@@ -0,0 +1,20 @@
+#include <kernel/tick.h>
+#include <kernel/workqueue.h>
+#include <kernel/time_page.h>
+#include <arch/cpu/scheduler.h>
+#include <lib/kprintf.h>
+
+static void tick_work_func(struct work *work)
+{
+	(void)work;
+	kprintf("!");
+}
+
+static struct work tick_work = WORK_INIT(tick_work, tick_work_func);
+
+void tick_handle_periodic(void)
+{
+	scheduler_tick();
+	time_page_update();
+	schedule_work(&tick_work);
+}
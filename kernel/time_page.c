@@ -0,0 +1,65 @@
+#include <kernel/time_page.h>
+#include <kernel/hrtimer.h>
+#include <kernel/kconfig.h>
+#include <arch/bsp/systimer.h>
+#include <arch/cpu/irq_flags.h>
+#include <arch/cpu/pmu.h>
+#include <arch/cpu/scheduler.h>
+#include <lib/atomic.h>
+
+static struct time_page page __attribute__((aligned(4096)));
+static uint32_t		last_now = 0;
+static uint64_t		true_us	 = 0; // systimer extended to 64 bit, page.us may be ahead
+
+static void update_timer_func(struct hrtimer *timer)
+{
+	(void)timer;
+	time_page_update();
+}
+
+static struct hrtimer update_timer = HRTIMER_INIT(update_timer_func);
+
+void time_page_update(void)
+{
+	uint32_t flags	= local_irq_save();
+	uint32_t now	= systimer_now();
+	uint32_t cycles = pmu_cycles();
+
+	uint32_t delta_us     = now - last_now;
+	uint32_t delta_cycles = cycles - page.cycles;
+
+	// Readers may have extrapolated past the systimer, they must not see time go back
+	uint64_t seen = page.us + time_page_extrapolate(&page, cycles);
+	true_us += delta_us;
+
+	page.seq++;
+	atomic_barrier();
+
+	page.jiffies = scheduler_jiffies();
+	page.us	     = true_us > seen ? true_us : seen;
+	// The shift keeps (delta_us << 16) in 32 bit for updates up to 65 ms apart
+	if (delta_cycles && delta_us < (1u << 16)) {
+		page.us_per_cycle_q16 = (delta_us << 16) / delta_cycles;
+	}
+	page.cycles = cycles;
+
+	atomic_barrier();
+	page.seq++;
+
+	last_now = now;
+	local_irq_restore(flags);
+}
+
+void time_page_init(void)
+{
+	last_now    = systimer_now();
+	page.cycles = pmu_cycles();
+	page.us	    = last_now;
+	true_us	    = last_now;
+	hrtimer_start(&update_timer, TIME_PAGE_PERIOD_US, TIME_PAGE_PERIOD_US);
+}
+
+const struct time_page *time_page_get(void)
+{
+	return &page;
+}
@@ -0,0 +1,219 @@
+#include <kernel/uring.h>
+#include <kernel/futex.h>
+#include <kernel/wait.h>
+#include <arch/bsp/uart.h>
+#include <arch/cpu/irq_flags.h>
+#include <arch/cpu/scheduler.h>
+#include <lib/atomic.h>
+#include <lib/kprintf.h>
+
+#define URING_MAX_RINGS	       4
+#define URING_POLL_IDLE_ROUNDS 64 // empty polls before the poller sleeps
+
+struct uring_ctx {
+	struct uring *ring;
+	tcb_t	     *owner;
+	wait_queue_t  cq_wait;
+};
+
+static struct uring_ctx contexts[URING_MAX_RINGS];
+static wait_queue_t	poller_wait = WAIT_QUEUE_INIT(poller_wait);
+static int		poller_tid  = -1;
+static bool		poller_kick = false;
+
+static uint32_t ops_total   = 0;
+static uint32_t enter_calls = 0;
+static uint32_t poller_ops  = 0;
+static uint32_t poller_naps = 0;
+
+static int32_t run_op(const struct uring_sqe *sqe)
+{
+	switch (sqe->op) {
+	case URING_OP_NOP:
+		return 0;
+	case URING_OP_WRITE:
+		preempt_disable();
+		uart_write((const char *)sqe->arg0, sqe->arg1);
+		preempt_enable();
+		return (int32_t)sqe->arg1;
+	case URING_OP_READ:
+		for (uint32_t i = 0; i < sqe->arg1; i++) {
+			((char *)sqe->arg0)[i] = uart_getc();
+		}
+		return (int32_t)sqe->arg1;
+	case URING_OP_SLEEP:
+		scheduler_sleep(sqe->arg0);
+		return 0;
+	case URING_OP_FUTEX_WAKE:
+		return futex_wake((volatile uint32_t *)sqe->arg0, sqe->arg1);
+	default:
+		return -1;
+	}
+}
+
+/* Runs submissions while the completion ring has room, returns how many */
+static uint32_t process(struct uring_ctx *ctx)
+{
+	struct uring *ring = ctx->ring;
+	uint32_t      done = 0;
+
+	while (ring->sq_head != ring->sq_tail && ring->cq_tail - ring->cq_head < URING_ENTRIES) {
+		atomic_barrier();
+		const struct uring_sqe *sqe = &ring->sq[ring->sq_head % URING_ENTRIES];
+		struct uring_cqe	cqe = { .user_data = sqe->user_data, .result = run_op(sqe) };
+
+		if (ctx->ring != ring) {
+			// Owner exited while the operation blocked
+			break;
+		}
+
+		ring->cq[ring->cq_tail % URING_ENTRIES] = cqe;
+		atomic_barrier();
+		ring->cq_tail++;
+		ring->sq_head++;
+		done++;
+	}
+
+	if (done) {
+		ops_total += done;
+		wake_up(&ctx->cq_wait);
+	}
+	return done;
+}
+
+static bool poller_pending(void)
+{
+	for (unsigned int i = 0; i < URING_MAX_RINGS; i++) {
+		struct uring *ring = contexts[i].ring;
+		if (ring && ring->sqpoll && ring->sq_head != ring->sq_tail) {
+			return true;
+		}
+	}
+	return poller_kick;
+}
+
+static void set_need_wakeup(bool set)
+{
+	for (unsigned int i = 0; i < URING_MAX_RINGS; i++) {
+		struct uring *ring = contexts[i].ring;
+		if (ring && ring->sqpoll) {
+			ring->flags = set ? URING_NEED_WAKEUP : 0;
+		}
+	}
+	atomic_barrier();
+}
+
+/*
+ * Polls all SQPOLL rings and yields in between. After a number of empty
+ * rounds it flags the rings and sleeps until uring_enter kicks it. The
+ * rings are checked once more after flagging, so a submission that did
+ * not see the flag is still picked up.
+ */
+static void poller_thread(void *arg)
+{
+	(void)arg;
+	uint32_t idle = 0;
+
+	for (;;) {
+		uint32_t done = 0;
+		for (unsigned int i = 0; i < URING_MAX_RINGS; i++) {
+			if (contexts[i].ring && contexts[i].ring->sqpoll) {
+				done += process(&contexts[i]);
+			}
+		}
+		poller_ops += done;
+
+		if (done) {
+			idle = 0;
+		} else if (++idle >= URING_POLL_IDLE_ROUNDS) {
+			set_need_wakeup(true);
+			poller_naps++;
+			wait_event(&poller_wait, poller_pending());
+			poller_kick = false;
+			set_need_wakeup(false);
+			idle = 0;
+		}
+		scheduler_yield();
+	}
+}
+
+int uring_register(struct uring *ring, uint32_t flags)
+{
+	uint32_t irq_flags = local_irq_save();
+	int	 id	   = -1;
+
+	for (int i = 0; i < URING_MAX_RINGS; i++) {
+		if (!contexts[i].ring) {
+			id = i;
+			break;
+		}
+	}
+	if (id < 0) {
+		local_irq_restore(irq_flags);
+		return -1;
+	}
+
+	ring->sq_head = ring->sq_tail = ring->sqe_tail = 0;
+	ring->cq_head = ring->cq_tail = 0;
+	ring->flags		      = 0;
+	ring->id		      = id;
+	ring->sqpoll		      = flags & URING_SETUP_SQPOLL;
+
+	contexts[id].ring  = ring;
+	contexts[id].owner = scheduler_get_current_thread();
+	wait_queue_init(&contexts[id].cq_wait);
+
+	if (ring->sqpoll && poller_tid < 0) {
+		poller_tid = scheduler_kthread_create(poller_thread, nullptr);
+	}
+	local_irq_restore(irq_flags);
+	return id;
+}
+
+int uring_enter(int id, uint32_t min_complete)
+{
+	if (id < 0 || id >= URING_MAX_RINGS || !contexts[id].ring) {
+		return -1;
+	}
+
+	struct uring_ctx *ctx  = &contexts[id];
+	struct uring	 *ring = ctx->ring;
+	uint32_t	  done = 0;
+
+	// More completions than are ready or submitted would never come
+	uint32_t possible = (ring->cq_tail - ring->cq_head) + (ring->sq_tail - ring->sq_head);
+	if (min_complete > possible) {
+		min_complete = possible;
+	}
+	if (min_complete > URING_ENTRIES) {
+		min_complete = URING_ENTRIES;
+	}
+
+	enter_calls++;
+	if (ring->sqpoll) {
+		uint32_t flags = local_irq_save();
+		poller_kick    = true;
+		wake_up(&poller_wait);
+		local_irq_restore(flags);
+	} else {
+		done = process(ctx);
+	}
+
+	wait_event(&ctx->cq_wait, ring->cq_tail - ring->cq_head >= min_complete);
+	return (int)done;
+}
+
+void uring_thread_exit(tcb_t *thread)
+{
+	for (unsigned int i = 0; i < URING_MAX_RINGS; i++) {
+		if (contexts[i].ring && contexts[i].owner == thread) {
+			contexts[i].ring = nullptr;
+		}
+	}
+}
+
+void uring_print_stats(void)
+{
+	kprintf("uring: %u ops, %u enter calls, %u ops by the poller, %u poller naps\n",
+		ops_total, enter_calls, poller_ops, poller_naps);
+}
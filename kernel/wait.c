@@ -0,0 +1,39 @@
+#include <kernel/wait.h>
+#include <arch/cpu/scheduler.h>
+
+void wait_queue_init(wait_queue_t *wq)
+{
+	list_init(&wq->head);
+}
+
+void wait_queue_sleep(wait_queue_t *wq)
+{
+	tcb_t *current = scheduler_get_current_thread();
+
+	list_add_last(&wq->head, &current->wait_node);
+	scheduler_block_current();
+}
+
+void wake_up(wait_queue_t *wq)
+{
+	uint32_t flags = local_irq_save();
+
+	while (!list_is_empty(&wq->head)) {
+		list_node *node = list_remove_first(&wq->head);
+		scheduler_wake(list_entry(node, tcb_t, wait_node));
+	}
+
+	local_irq_restore(flags);
+}
+
+void wake_up_one(wait_queue_t *wq)
+{
+	uint32_t flags = local_irq_save();
+
+	list_node *node = list_remove_first(&wq->head);
+	if (node) {
+		scheduler_wake(list_entry(node, tcb_t, wait_node));
+	}
+
+	local_irq_restore(flags);
+}
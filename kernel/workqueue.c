@@ -0,0 +1,46 @@
+#include <kernel/workqueue.h>
+#include <kernel/wait.h>
+#include <arch/cpu/irq_flags.h>
+#include <arch/cpu/scheduler.h>
+
+static list_node    work_list	= { &work_list, &work_list };
+static wait_queue_t worker_wait = WAIT_QUEUE_INIT(worker_wait);
+
+bool schedule_work(struct work *work)
+{
+	uint32_t flags = local_irq_save();
+
+	if (work->pending) {
+		local_irq_restore(flags);
+		return false;
+	}
+
+	work->pending = true;
+	list_add_last(&work_list, &work->node);
+	wake_up(&worker_wait);
+
+	local_irq_restore(flags);
+	return true;
+}
+
+static void worker_thread(void *arg)
+{
+	(void)arg;
+
+	while (true) {
+		wait_event(&worker_wait, !list_is_empty(&work_list));
+
+		uint32_t     flags = local_irq_save();
+		struct work *work  = list_entry(list_remove_first(&work_list), struct work, node);
+		work->pending	   = false;
+		local_irq_restore(flags);
+
+		work->func(work);
+	}
+}
+
+void workqueue_init(void)
+{
+	int tid = scheduler_kthread_create(worker_thread, nullptr);
+	scheduler_set_urgent(tid);
+}
@@ -0,0 +1,73 @@
+#include <lib/histogram.h>
+#include <lib/kprintf.h>
+#include <lib/mem.h>
+
+static unsigned int bucket_of(uint32_t value)
+{
+	if (value == 0) {
+		return 0;
+	}
+	unsigned int bucket = 32 - (unsigned int)__builtin_clz(value);
+	return bucket < HIST_BUCKETS ? bucket : HIST_BUCKETS - 1;
+}
+
+static uint32_t bucket_low(unsigned int bucket)
+{
+	return bucket ? 1u << (bucket - 1) : 0;
+}
+
+static uint32_t bucket_high(unsigned int bucket)
+{
+	return bucket < HIST_BUCKETS - 1 ? (1u << bucket) - 1 : UINT32_MAX;
+}
+
+void hist_reset(struct log2_hist *hist)
+{
+	memset(hist, 0, sizeof(*hist));
+	hist->min = UINT32_MAX;
+}
+
+void hist_record(struct log2_hist *hist, uint32_t value)
+{
+	hist->buckets[bucket_of(value)]++;
+	hist->count++;
+	hist->total += value;
+	if (value < hist->min) {
+		hist->min = value;
+	}
+	if (value > hist->max) {
+		hist->max = value;
+	}
+}
+
+uint32_t hist_percentile(const struct log2_hist *hist, unsigned int p)
+{
+	// Smallest rank that covers p percent, rounded up
+	uint32_t rank = (hist->count * p + 99) / 100;
+	uint32_t seen = 0;
+
+	for (unsigned int i = 0; i < HIST_BUCKETS; i++) {
+		seen += hist->buckets[i];
+		if (seen >= rank && seen > 0) {
+			return bucket_high(i) < hist->max ? bucket_high(i) : hist->max;
+		}
+	}
+	return 0;
+}
+
+void hist_print(const char *prefix, const struct log2_hist *hist)
+{
+	if (!hist->count) {
+		kprintf("%s n=0\n", prefix);
+		return;
+	}
+
+	kprintf("%s n=%u min=%u avg=%u max=%u p99<=%u\n", prefix, hist->count, hist->min,
+		hist->total / hist->count, hist->max, hist_percentile(hist, 99));
+	for (unsigned int i = 0; i < HIST_BUCKETS; i++) {
+		if (hist->buckets[i]) {
+			kprintf("%s bucket=%u-%u count=%u\n", prefix, bucket_low(i), bucket_high(i),
+				hist->buckets[i]);
+		}
+	}
+}
@@ -6,11 +6,30 @@
 #include <stdint.h>
 #define POINTER_STRING_LENGTH 11
 
-// Main kprintf
-void kprintf(const char *fmt, ...)
+static void put_string(format_putc_t out, void *ctx, const char *s)
 {
-	va_list args;
-	va_start(args, fmt);
+	while (*s) {
+		out(ctx, *s++);
+	}
+}
+
+// Helper: print digits with width and padding, a minus goes before '0' padding
+static void put_padded(format_putc_t out, void *ctx, const char *digits, int len, int width,
+		       char pad_char)
+{
+	if (pad_char == '0' && *digits == '-') {
+		out(ctx, *digits++);
+	}
+	for (int i = len; i < width; i++) {
+		out(ctx, pad_char);
+	}
+	put_string(out, ctx, digits);
+}
+
+// Formatter shared by kprintf and the user printf
+void vformat(format_putc_t out, void *ctx, const char *fmt, va_list args)
+{
+	char digits[12];
 
 	while (*fmt) {
 		if (*fmt == '%') {
@@ -29,43 +48,57 @@ void kprintf(const char *fmt, ...)
 
 			switch (*fmt++) {
 			case 'c':
-				uart_putc(va_arg(args, int));
+				out(ctx, (char)va_arg(args, int));
 				break;
 			case 's':
-				uart_puts(va_arg(args, const char *));
+				put_string(out, ctx, va_arg(args, const char *));
 				break;
 			case 'i':
-				send_int_width(va_arg(args, int), width, pad_char);
+				put_padded(out, ctx, digits, int_to_str(va_arg(args, int), digits),
+					   width, pad_char);
 				break;
 			case 'u':
-				send_unsigned_width(va_arg(args, unsigned int), width, pad_char,
-						    false);
+				put_padded(out, ctx, digits,
+					   uint_to_str(va_arg(args, unsigned int), digits), width,
+					   pad_char);
 				break;
 			case 'x':
-				send_unsigned_width(va_arg(args, unsigned int), width, pad_char,
-						    true);
+				put_padded(out, ctx, digits,
+					   uint_to_hex_str(va_arg(args, unsigned int), digits), width,
+					   pad_char);
 				break;
 			case 'p':
-				send_pointer(va_arg(args, void *));
+				// Pointer as 0xXXXXXXXX
+				put_string(out, ctx, "0x");
+				put_padded(out, ctx, digits,
+					   uint_to_hex_str((uintptr_t)va_arg(args, void *), digits),
+					   8, '0');
 				break;
 			case '%':
-				uart_putc('%');
+				out(ctx, '%');
 				break;
 			default:
-				uart_puts("Unknown conversion specifier");
+				put_string(out, ctx, "Unknown conversion specifier");
 			}
 		} else {
-			uart_putc(*fmt++);
+			out(ctx, *fmt++);
 		}
 	}
+}
 
-	va_end(args);
+static void uart_put(void *ctx, char c)
+{
+	(void)ctx;
+	uart_putc(c);
 }
-// Helper: print padding
-void print_padding(int width, char pad_char, int content_len)
+
+// Main kprintf
+void kprintf(const char *fmt, ...)
 {
-	for (int i = content_len; i < width; i++)
-		uart_putc(pad_char);
+	va_list args;
+	va_start(args, fmt);
+	vformat(uart_put, nullptr, fmt, args);
+	va_end(args);
 }
 
 // Helper: convert int to string (decimal)
@@ -144,49 +177,3 @@ int uint_to_hex_str(unsigned int value, char *buffer)
 	buffer[len] = '\0';
 	return len;
 }
-
-// Print integer with width and padding
-void send_int_width(int value, int width, char pad_char)
-{
-	char buf[12];
-	int  len = int_to_str(value, buf);
-
-	if (pad_char == '0' && value < 0) {
-		uart_putc('-'); // print minus first
-		print_padding(width, pad_char, len); // subtract 1 because '-' already printed
-		uart_puts(buf + 1); // skip the minus in the string
-	} else {
-		print_padding(width, pad_char, len);
-		uart_puts(buf);
-	}
-}
-
-// Print unsigned int / hex with width and padding
-void send_unsigned_width(unsigned int value, int width, char pad_char, bool hex)
-{
-	char buf[12];
-	int  len;
-	if (hex)
-		len = uint_to_hex_str(value, buf);
-	else
-		len = uint_to_str(value, buf); // for %u
-
-	print_padding(width, pad_char, len);
-	uart_puts(buf);
-}
-
-// Print pointer as 0xXXXXXXXX
-void send_pointer(void *ptr)
-{
-	char	  buf[11]; // 0x + 8 digits + '\0'
-	uintptr_t addr = (uintptr_t)ptr;
-	buf[0]	       = '0';
-	buf[1]	       = 'x';
-	for (int i = 0; i < 8; i++) {
-		int shift  = (7 - i) * 4;
-		int digit  = (addr >> shift) & 0xF;
-		buf[2 + i] = digit < 10 ? '0' + digit : 'a' + (digit - 10);
-	}
-	buf[10] = '\0';
-	uart_puts(buf);
-}
@@ -0,0 +1,229 @@
+/*
+ * Microbenchmarks of the kernel's basic operations, measured with the
+ * PMU cycle counter.
+ *
+ * Build with: make TSRC=tests/bench.c qemu (or make bench)
+ *
+ * Every benchmark collects SAMPLES single measurements and prints one
+ * line of the form
+ *
+ *   bench name=<name> unit=<unit> n=<n> min=.. p50=.. p90=.. p99=.. max=..
+ *
+ * followed by "bench done". Under QEMU with -icount the cycle counter
+ * follows the instruction count, so the numbers are repeatable and
+ * comparable between two builds, not the ones real hardware would show.
+ */
+#include <arch/bsp/irq_controller.h>
+#include <arch/cpu/pmu.h>
+#include <arch/cpu/scheduler.h>
+#include <kernel/wait.h>
+#include <lib/kprintf.h>
+#include <lib/mem.h>
+#include <user/syscall.h>
+
+#define SAMPLES	   256
+#define COPY_BYTES (16 * 1024)
+
+static uint32_t samples[SAMPLES];
+static uint32_t exit_samples[SAMPLES];
+
+static char copy_src[COPY_BYTES];
+static char copy_dst[COPY_BYTES];
+
+static const char kprintf_line[] =
+	"# kprintf throughput ............................................";
+
+static wait_queue_t bench_wq = WAIT_QUEUE_INIT(bench_wq);
+static volatile bool thread_done;
+static volatile bool partner_stop;
+static volatile uint32_t irq_stamp;
+static volatile uint32_t exit_start;
+static volatile uint32_t exit_end;
+
+static void sort(uint32_t *values, unsigned int n)
+{
+	for (unsigned int i = 1; i < n; i++) {
+		uint32_t value = values[i];
+		unsigned int j = i;
+		for (; j > 0 && values[j - 1] > value; j--) {
+			values[j] = values[j - 1];
+		}
+		values[j] = value;
+	}
+}
+
+static uint32_t percentile(const uint32_t *sorted, unsigned int n, unsigned int p)
+{
+	unsigned int index = n * p / 100;
+	return sorted[index < n ? index : n - 1];
+}
+
+static void report(const char *name, const char *unit, uint32_t *values, unsigned int n)
+{
+	sort(values, n);
+	kprintf("bench name=%s unit=%s n=%u min=%u p50=%u p90=%u p99=%u max=%u\n", name, unit, n,
+		values[0], percentile(values, n, 50), percentile(values, n, 90),
+		percentile(values, n, 99), values[n - 1]);
+}
+
+static void thread_exited(tcb_t *thread)
+{
+	(void)thread;
+	exit_end    = pmu_cycles();
+	thread_done = true;
+	wake_up(&bench_wq);
+}
+
+/* Call under preempt_disable right after creating tid, before it can run and exit */
+static void watch_exit(int tid)
+{
+	scheduler_set_exit_hook(tid, thread_exited);
+}
+
+static void wait_for_exit(void)
+{
+	wait_event(&bench_wq, thread_done);
+	thread_done = false;
+}
+
+static void bench_memcpy(void)
+{
+	for (unsigned int i = 0; i < SAMPLES; i++) {
+		uint32_t start = pmu_cycles();
+		memcpy(copy_dst, copy_src, COPY_BYTES);
+		samples[i] = (pmu_cycles() - start) / (COPY_BYTES / 1024);
+	}
+	report("memcpy", "cycles_per_kib", samples, SAMPLES);
+}
+
+static void bench_kprintf(void)
+{
+	constexpr uint32_t chars = sizeof(kprintf_line); // the newline replaces the NUL
+
+	for (unsigned int i = 0; i < SAMPLES; i++) {
+		uint32_t start = pmu_cycles();
+		kprintf("%s\n", kprintf_line);
+		samples[i] = (pmu_cycles() - start) / chars;
+	}
+	report("kprintf", "cycles_per_char", samples, SAMPLES);
+}
+
+static void mailbox_handler(void *ctx)
+{
+	(void)ctx;
+	irq_stamp = pmu_cycles();
+}
+
+/* From the mailbox write that raises the IRQ to the first line of its handler */
+static void bench_irq_entry(void)
+{
+	if (request_irq(IRQ_LOCAL_MAILBOX1, mailbox_handler, nullptr) < 0) {
+		kprintf("bench name=irq_entry error=mailbox_taken\n");
+		return;
+	}
+
+	for (unsigned int i = 0; i < SAMPLES; i++) {
+		irq_stamp      = 0;
+		uint32_t start = pmu_cycles();
+		irq_controller_raise_mailbox(1);
+		while (!irq_stamp) {
+		}
+		samples[i] = irq_stamp - start;
+	}
+	free_irq(IRQ_LOCAL_MAILBOX1);
+	report("irq_entry", "cycles", samples, SAMPLES);
+}
+
+static void yield_partner(void *arg)
+{
+	(void)arg;
+	while (!partner_stop) {
+		scheduler_yield();
+	}
+}
+
+/* Half a yield round trip between two kernel threads is one switch */
+static void bench_context_switch(void)
+{
+	partner_stop = false;
+	preempt_disable();
+	watch_exit(scheduler_kthread_create(yield_partner, nullptr));
+	preempt_enable();
+	scheduler_yield();
+
+	for (unsigned int i = 0; i < SAMPLES; i++) {
+		uint32_t start = pmu_cycles();
+		scheduler_yield();
+		samples[i] = (pmu_cycles() - start) / 2;
+	}
+
+	partner_stop = true;
+	wait_for_exit();
+	report("context_switch", "cycles", samples, SAMPLES);
+}
+
+static void null_svc_thread(void *arg)
+{
+	(void)arg;
+	for (unsigned int i = 0; i < SAMPLES; i++) {
+		uint32_t start = pmu_cycles();
+		sys_null();
+		samples[i] = pmu_cycles() - start;
+	}
+}
+
+static void bench_null_svc(void)
+{
+	preempt_disable();
+	watch_exit(scheduler_thread_create(null_svc_thread, nullptr, 0));
+	preempt_enable();
+
+	wait_for_exit();
+	report("null_svc", "cycles", samples, SAMPLES);
+}
+
+static void exit_thread(void *arg)
+{
+	(void)arg;
+	exit_start = pmu_cycles();
+}
+
+/*
+ * Create is timed around scheduler_thread_create, exit from the return
+ * of the thread function until scheduler_exit runs the exit hook.
+ */
+static void bench_thread_lifecycle(void)
+{
+	for (unsigned int i = 0; i < SAMPLES; i++) {
+		// The new thread must not run before its exit hook is set
+		preempt_disable();
+		uint32_t start = pmu_cycles();
+		int	 tid   = scheduler_thread_create(exit_thread, nullptr, 0);
+		samples[i]     = pmu_cycles() - start;
+		watch_exit(tid);
+		preempt_enable();
+
+		wait_for_exit();
+		exit_samples[i] = exit_end - exit_start;
+	}
+	report("thread_create", "cycles", samples, SAMPLES);
+	report("thread_exit", "cycles", exit_samples, SAMPLES);
+}
+
+static void bench_thread(void *arg)
+{
+	(void)arg;
+
+	bench_memcpy();
+	bench_kprintf();
+	bench_irq_entry();
+	bench_context_switch();
+	bench_null_svc();
+	bench_thread_lifecycle();
+	kprintf("bench done\n");
+}
+
+void test_kernel(void)
+{
+	scheduler_kthread_create(bench_thread, nullptr);
+}
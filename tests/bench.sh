@@ -0,0 +1,9 @@
+#!/bin/sh
+# Runs the microbenchmarks of tests/bench.c and prints only the result
+# lines, one "bench key=value ..." line per benchmark. The build starts
+# clean, objects left by other TSRC or CFLAGS builds would be linked in.
+# QEMU does not exit on its own, the run is cut off after RUN_SECONDS.
+RUN_SECONDS=${RUN_SECONDS:-60}
+
+make clean > /dev/null
+timeout "$RUN_SECONDS" make TSRC=tests/bench.c qemu 2>&1 | grep '^bench '
@@ -0,0 +1,114 @@
+/*
+ * Cost of a coroutine switch against a kernel thread switch, and a
+ * coroutine that waits for a semaphore without stalling the others.
+ *
+ * Build with: make TSRC=tests/coro_bench.c qemu
+ *
+ * Two coroutines of one thread yield to each other, then two user
+ * threads do the same with sys_yield. In the second part one coroutine
+ * waits for a semaphore posted by another thread while its sibling
+ * keeps working; the thread may only block in the kernel once the
+ * sibling is done.
+ */
+#include <arch/cpu/pmu.h>
+#include <arch/cpu/scheduler.h>
+#include <lib/kprintf.h>
+#include <user/coro.h>
+#include <user/sync.h>
+#include <user/syscall.h>
+
+#define ROUNDS	      2000
+#define CORO_STACK    2048
+#define WORKER_ROUNDS 50
+
+static uint8_t		 stacks[2][CORO_STACK] __attribute__((aligned(8)));
+static struct coro_sched sched;
+
+static sem_t		 kernel_start = SEM_INIT(0);
+static sem_t		 kernel_done  = SEM_INIT(0);
+static sem_t		 event	      = SEM_INIT(0);
+static volatile uint32_t worker_progress = 0;
+static volatile uint32_t progress_at_event;
+
+static void ping_coro(struct coro_sched *sched, void *arg)
+{
+	(void)arg;
+	for (unsigned int i = 0; i < ROUNDS; i++) {
+		coro_yield(sched);
+	}
+}
+
+static void waiter_coro(struct coro_sched *sched, void *arg)
+{
+	(void)arg;
+	coro_sem_wait(sched, &event);
+	progress_at_event = worker_progress;
+}
+
+static void worker_coro(struct coro_sched *sched, void *arg)
+{
+	(void)arg;
+	for (unsigned int i = 0; i < WORKER_ROUNDS; i++) {
+		worker_progress++;
+		coro_yield(sched);
+	}
+}
+
+static void kernel_yield_thread(void *arg)
+{
+	(void)arg;
+	sem_wait(&kernel_start);
+	for (unsigned int i = 0; i < ROUNDS; i++) {
+		sys_yield();
+	}
+	sem_post(&kernel_done);
+}
+
+static void event_thread(void *arg)
+{
+	(void)arg;
+	// Runs once the coroutine thread blocks in the kernel
+	coro_sem_post(&sched, &event);
+}
+
+static void bench_thread(void *arg)
+{
+	(void)arg;
+	struct coro coros[2];
+
+	coro_sched_init(&sched);
+	coro_create(&sched, &coros[0], stacks[0], CORO_STACK, ping_coro, nullptr);
+	coro_create(&sched, &coros[1], stacks[1], CORO_STACK, ping_coro, nullptr);
+	uint32_t start = pmu_cycles();
+	coro_run(&sched);
+	uint32_t coro_cycles = pmu_cycles() - start;
+	uint32_t coro_switches = sched.switches;
+
+	// Two threads yielding: this one and kernel_yield_thread
+	sem_post(&kernel_start);
+	start = pmu_cycles();
+	for (unsigned int i = 0; i < ROUNDS; i++) {
+		sys_yield();
+	}
+	uint32_t kernel_cycles = pmu_cycles() - start;
+	sem_wait(&kernel_done);
+
+	kprintf("\ncoro_bench coro_switch_cycles=%u kernel_switch_cycles=%u\n",
+		coro_cycles / coro_switches, kernel_cycles / (2 * ROUNDS));
+
+	coro_sched_init(&sched);
+	coro_create(&sched, &coros[0], stacks[0], CORO_STACK, waiter_coro, nullptr);
+	coro_create(&sched, &coros[1], stacks[1], CORO_STACK, worker_coro, nullptr);
+	scheduler_thread_create(event_thread, nullptr, 0);
+	coro_run(&sched);
+
+	kprintf("coro_bench worker_progress_at_event=%u of %u kernel_blocks=%u ok=%s\n",
+		progress_at_event, WORKER_ROUNDS, sched.kernel_blocks,
+		progress_at_event == WORKER_ROUNDS ? "yes" : "NO");
+}
+
+void test_kernel(void)
+{
+	scheduler_thread_create(bench_thread, nullptr, 0);
+	scheduler_thread_create(kernel_yield_thread, nullptr, 0);
+}
@@ -0,0 +1,133 @@
+/*
+ * Timer wake up latency under load, in the spirit of cyclictest.
+ *
+ * Build with: make TSRC=tests/cyclictest.c qemu
+ *
+ * A periodic hrtimer wakes an urgent kernel thread every PERIOD_US
+ * while CPU bound user threads and a UART flood compete for the core.
+ * Every expiration is recorded against its deadline at three points:
+ *
+ *   irq_entry  entry of irq_c, from the cycles spent until the callback
+ *   handler    the hrtimer callback
+ *   dispatch   the woken thread running again
+ *
+ * Latencies are in µs and go into log2 histograms. Wake ups the thread
+ * missed because it was still behind are counted as overruns.
+ */
+#include <arch/bsp/systimer.h>
+#include <arch/cpu/interrupts.h>
+#include <arch/cpu/pmu.h>
+#include <arch/cpu/scheduler.h>
+#include <kernel/hrtimer.h>
+#include <kernel/wait.h>
+#include <lib/histogram.h>
+#include <lib/kprintf.h>
+#include <user/syscall.h>
+
+#define PERIOD_US	1000
+#define SAMPLES		2000
+#define CALIBRATE_US	10000
+#define LOAD_THREADS	6
+#define LOAD_SPIN	20000
+
+static void timer_func(struct hrtimer *timer);
+
+static struct hrtimer	cyclic_timer = HRTIMER_INIT(timer_func);
+static wait_queue_t	wake_wq	     = WAIT_QUEUE_INIT(wake_wq);
+static struct log2_hist irq_entry_hist;
+static struct log2_hist handler_hist;
+static struct log2_hist dispatch_hist;
+
+static uint32_t		 cycles_per_us = 1;
+static uint32_t		 expected; // deadline of the next expiration
+static volatile uint32_t fired;	   // deadline of the last expiration
+static volatile uint32_t wakeups;
+static volatile bool	 stop;
+
+static void timer_func(struct hrtimer *timer)
+{
+	uint32_t late	   = systimer_now() - expected;
+	uint32_t in_irq_us = (pmu_cycles() - irq_get_entry_cycles()) / cycles_per_us;
+
+	hist_record(&handler_hist, late);
+	hist_record(&irq_entry_hist, late > in_irq_us ? late - in_irq_us : 0);
+
+	fired	 = expected;
+	expected = timer->expires; // already advanced by the hrtimer core
+	wakeups++;
+	wake_up(&wake_wq);
+}
+
+static void calibrate(void)
+{
+	uint32_t start_us     = systimer_now();
+	uint32_t start_cycles = pmu_cycles();
+	while (systimer_now() - start_us < CALIBRATE_US) {
+	}
+	cycles_per_us = (pmu_cycles() - start_cycles) / CALIBRATE_US;
+	if (!cycles_per_us) {
+		cycles_per_us = 1;
+	}
+}
+
+static void measure_thread(void *arg)
+{
+	(void)arg;
+
+	hist_reset(&irq_entry_hist);
+	hist_reset(&handler_hist);
+	hist_reset(&dispatch_hist);
+	calibrate();
+
+	uint32_t flags = local_irq_save();
+	hrtimer_start(&cyclic_timer, PERIOD_US, PERIOD_US);
+	expected = cyclic_timer.expires;
+	local_irq_restore(flags);
+
+	uint32_t seen = 0;
+	for (unsigned int i = 0; i < SAMPLES; i++) {
+		wait_event(&wake_wq, wakeups != seen);
+		hist_record(&dispatch_hist, systimer_now() - fired);
+		seen = wakeups;
+	}
+	hrtimer_cancel(&cyclic_timer);
+	stop = true;
+
+	kprintf("\ncyclictest period_us=%u cycles_per_us=%u load_threads=%u overruns=%u\n",
+		PERIOD_US, cycles_per_us, LOAD_THREADS, wakeups - SAMPLES);
+	hist_print("cyclictest path=irq_entry", &irq_entry_hist);
+	hist_print("cyclictest path=handler", &handler_hist);
+	hist_print("cyclictest path=dispatch", &dispatch_hist);
+}
+
+static void load_thread(void *arg)
+{
+	(void)arg;
+	while (!stop) {
+		for (volatile unsigned int i = 0; i < LOAD_SPIN; i++) {
+		}
+		sys_yield();
+	}
+}
+
+static void flood_thread(void *arg)
+{
+	(void)arg;
+	static const char line[] = "cyclictest uart flood .....................................\n";
+
+	while (!stop) {
+		sys_write(line, sizeof(line) - 1);
+		sys_yield();
+	}
+}
+
+void test_kernel(void)
+{
+	int tid = scheduler_kthread_create(measure_thread, nullptr);
+	scheduler_set_urgent(tid);
+
+	for (unsigned int i = 0; i < LOAD_THREADS; i++) {
+		scheduler_thread_create(load_thread, nullptr, 0);
+	}
+	scheduler_thread_create(flood_thread, nullptr, 0);
+}
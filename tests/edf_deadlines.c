@@ -0,0 +1,91 @@
+/*
+ * Missed deadlines of periodic EDF threads under background load.
+ *
+ * Build with: make TSRC=tests/edf_deadlines.c qemu
+ *
+ * Three admitted control loops share the CPU with busy normal threads.
+ * A fourth loop would push the density above RT_UTIL_MAX_PERMILLE and
+ * must be rejected. After the measurement every loop should report
+ * zero missed deadlines.
+ */
+#include <arch/bsp/systimer.h>
+#include <arch/cpu/scheduler.h>
+#include <lib/kprintf.h>
+
+#define BACKGROUND_THREADS 4
+#define REPORT_PERIODS	   4
+
+struct rt_loop {
+	uint32_t runtime;
+	uint32_t period;
+	uint32_t deadline;
+	uint32_t work; // µs of busy work per job, below runtime
+};
+
+static struct rt_loop loops[] = {
+	{ 2000, 10000, 8000, 1500 },
+	{ 5000, 20000, 20000, 4000 },
+	{ 6000, 30000, 25000, 5000 },
+};
+
+static struct rt_loop rejected_loop = { 5000, 10000, 10000, 0 };
+
+static volatile bool stop = false;
+
+static void busy_us(uint32_t us)
+{
+	uint32_t start = systimer_now();
+	while (systimer_now() - start < us) {
+	}
+}
+
+static void rt_loop_thread(void *arg)
+{
+	struct rt_loop *loop = arg;
+
+	if (sched_rt_set(scheduler_get_current_thread(), loop->runtime, loop->period,
+			 loop->deadline) < 0) {
+		kprintf("\nrt loop %u/%u not admitted\n", loop->runtime, loop->period);
+		return;
+	}
+
+	while (!stop) {
+		busy_us(loop->work);
+		sched_rt_wait_period();
+	}
+}
+
+static void background_thread(void *arg)
+{
+	(void)arg;
+	while (!stop) {
+	}
+}
+
+/* Reports from the RT class itself, normal threads would starve behind the load */
+static void report_thread(void *arg)
+{
+	(void)arg;
+
+	sched_rt_set(scheduler_get_current_thread(), 100, 500000, 500000);
+	for (unsigned int i = 0; i < REPORT_PERIODS; i++) {
+		sched_rt_wait_period();
+	}
+
+	stop = true;
+	kprintf("\n");
+	sched_rt_print_stats();
+}
+
+/* Busy threads last, round robin starts with the lowest id and they never yield */
+void test_kernel(void)
+{
+	for (unsigned int i = 0; i < sizeof(loops) / sizeof(loops[0]); i++) {
+		scheduler_kthread_create(rt_loop_thread, &loops[i]);
+	}
+	scheduler_kthread_create(rt_loop_thread, &rejected_loop);
+	scheduler_kthread_create(report_thread, nullptr);
+	for (unsigned int i = 0; i < BACKGROUND_THREADS; i++) {
+		scheduler_kthread_create(background_thread, nullptr);
+	}
+}
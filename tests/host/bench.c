@@ -0,0 +1,163 @@
+/*
+ * Host microbenchmarks of lib/ and the scheduling policies, in the
+ * style of Google Benchmark: every benchmark runs a growing number of
+ * iterations until one run takes at least MIN_RUN_NS, then reports
+ * the time per iteration. Host numbers only compare two versions of
+ * the same code, they say nothing absolute about the Cortex-A7.
+ */
+#include "host.h"
+#include <time.h>
+#include <arch/cpu/scheduler.h>
+#include <lib/histogram.h>
+#include <lib/kprintf.h>
+#include <lib/list.h>
+#include <lib/ringbuffer.h>
+
+#define MIN_RUN_NS    200000000ull
+#define COPY_BYTES    4096
+#define BENCH_THREADS 31
+
+struct benchmark {
+	const char *name;
+	void (*run)(uint64_t iterations);
+};
+
+static uint64_t now_ns(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+create_ringbuffer(bench_ring, 64);
+
+static void bm_ringbuffer_put_get(uint64_t iterations)
+{
+	for (uint64_t i = 0; i < iterations; i++) {
+		(void)buff_putc(bench_ring, (char)i);
+		do_not_optimize(buff_getc(bench_ring));
+	}
+}
+
+static void bm_list_add_remove(uint64_t iterations)
+{
+	list_node head;
+	list_node nodes[8];
+
+	list_init(&head);
+	for (int i = 0; i < 8; i++) {
+		list_add_last(&head, &nodes[i]);
+	}
+	for (uint64_t i = 0; i < iterations; i++) {
+		list_node *node = list_remove_first(&head);
+		list_add_last(&head, node);
+		do_not_optimize(node);
+	}
+}
+
+static void bm_kprintf_format(uint64_t iterations)
+{
+	for (uint64_t i = 0; i < iterations; i++) {
+		uart_capture_reset();
+		kprintf("tid=%u pc=%08x %s\n", (unsigned int)i, 0x8000u, "svc");
+	}
+}
+
+static unsigned char copy_src[COPY_BYTES];
+static unsigned char copy_dst[COPY_BYTES];
+
+static void bm_kmem_memcpy_4k(uint64_t iterations)
+{
+	for (uint64_t i = 0; i < iterations; i++) {
+		kmem_memcpy(copy_dst, copy_src, COPY_BYTES);
+		do_not_optimize(copy_dst);
+	}
+}
+
+static void bm_libc_memcpy_4k(uint64_t iterations)
+{
+	for (uint64_t i = 0; i < iterations; i++) {
+		memcpy(copy_dst, copy_src, COPY_BYTES);
+		do_not_optimize(copy_dst);
+	}
+}
+
+static void bm_hist_record(uint64_t iterations)
+{
+	struct log2_hist hist;
+
+	hist_reset(&hist);
+	for (uint64_t i = 0; i < iterations; i++) {
+		hist_record(&hist, (uint32_t)i & 0xFFFF);
+	}
+	do_not_optimize(hist.count);
+}
+
+/* One enqueue and one pick with BENCH_THREADS ready threads */
+static void bm_sched_rr_pick(uint64_t iterations)
+{
+	sched_rr_init();
+	for (int i = 1; i <= BENCH_THREADS; i++) {
+		scheduler_get_thread(i)->thread_id = (uint32_t)i;
+		sched_rr_enqueue(scheduler_get_thread(i), false);
+	}
+	for (uint64_t i = 0; i < iterations; i++) {
+		tcb_t *next = sched_rr_pick_next();
+		sched_rr_enqueue(next, false);
+	}
+}
+
+static void bm_sched_fair_pick(uint64_t iterations)
+{
+	// The heap keeps its threads between runs, queue them only once
+	static bool queued = false;
+	for (int i = 1; i <= BENCH_THREADS && !queued; i++) {
+		tcb_t *thread	  = scheduler_get_thread(i);
+		thread->thread_id = (uint32_t)i;
+		sched_fair_init_thread(thread);
+		sched_fair_enqueue(thread, false);
+	}
+	queued = true;
+
+	for (uint64_t i = 0; i < iterations; i++) {
+		tcb_t *next = sched_fair_pick_next();
+		sched_fair_charge(next, 1000 + (uint32_t)(i & 0xFF));
+		sched_fair_enqueue(next, false);
+	}
+}
+
+static const struct benchmark benchmarks[] = {
+	{ "ringbuffer_put_get", bm_ringbuffer_put_get },
+	{ "list_add_remove", bm_list_add_remove },
+	{ "kprintf_format", bm_kprintf_format },
+	{ "kmem_memcpy_4k", bm_kmem_memcpy_4k },
+	{ "libc_memcpy_4k", bm_libc_memcpy_4k },
+	{ "hist_record", bm_hist_record },
+	{ "sched_rr_pick", bm_sched_rr_pick },
+	{ "sched_fair_pick", bm_sched_fair_pick },
+};
+
+int main(void)
+{
+	printf("%-24s %12s %12s\n", "benchmark", "ns/iter", "iterations");
+
+	for (size_t b = 0; b < sizeof(benchmarks) / sizeof(benchmarks[0]); b++) {
+		uint64_t iterations = 1;
+		uint64_t elapsed;
+
+		while (true) {
+			uint64_t start = now_ns();
+			benchmarks[b].run(iterations);
+			elapsed = now_ns() - start;
+			if (elapsed >= MIN_RUN_NS || iterations >= (1ull << 40)) {
+				break;
+			}
+			// Aim a bit above the minimum, at most 10x per step
+			uint64_t next = elapsed ? iterations * MIN_RUN_NS * 14 / 10 / elapsed : 0;
+			iterations    = next > iterations * 10 || !next ? iterations * 10 : next;
+		}
+		printf("%-24s %12.2f %12llu\n", benchmarks[b].name, (double)elapsed / (double)iterations,
+		       (unsigned long long)iterations);
+	}
+	return 0;
+}
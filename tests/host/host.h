@@ -0,0 +1,56 @@
+#ifndef TESTS_HOST_HOST_H
+#define TESTS_HOST_HOST_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+extern unsigned int host_checks;
+extern unsigned int host_failures;
+
+#define CHECK(cond)                                                                       \
+	do {                                                                              \
+		host_checks++;                                                            \
+		if (!(cond)) {                                                            \
+			host_failures++;                                                  \
+			fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__,  \
+				#cond);                                                   \
+		}                                                                         \
+	} while (0)
+
+#define CHECK_STR(actual, expected)                                                       \
+	do {                                                                              \
+		host_checks++;                                                            \
+		if (strcmp((actual), (expected)) != 0) {                                  \
+			host_failures++;                                                  \
+			fprintf(stderr, "%s:%d: got \"%s\", expected \"%s\"\n", __FILE__, \
+				__LINE__, (actual), (expected));                          \
+		}                                                                         \
+	} while (0)
+
+/* Keeps the compiler from dropping a benchmarked result */
+#define do_not_optimize(value) asm volatile("" : : "g"(value) : "memory")
+
+/* Everything the uart stub got since the last reset, NUL terminated */
+const char *uart_captured(void);
+void	    uart_capture_reset(void);
+
+/* Deterministic xorshift32, the property tests replay with the same seed */
+uint32_t host_random(void);
+void	 host_random_seed(uint32_t seed);
+
+/* lib/mem.c, renamed at build time so the host libc keeps its own */
+int   kmem_memcmp(const void *s1, const void *s2, size_t n);
+void *kmem_memcpy(void *restrict s1, const void *restrict s2, size_t n);
+void *kmem_memmove(void *s1, const void *s2, size_t n);
+void *kmem_memset(void *s, int c, size_t n);
+
+void test_list(void);
+void test_ringbuffer(void);
+void test_kprintf(void);
+void test_mem(void);
+void test_histogram(void);
+void test_sched(void);
+
+#endif
@@ -0,0 +1,17 @@
+#include "host.h"
+
+unsigned int host_checks   = 0;
+unsigned int host_failures = 0;
+
+int main(void)
+{
+	test_list();
+	test_ringbuffer();
+	test_kprintf();
+	test_mem();
+	test_histogram();
+	test_sched();
+
+	printf("host tests: %u checks, %u failed\n", host_checks, host_failures);
+	return host_failures ? 1 : 0;
+}
@@ -0,0 +1,73 @@
+#include "host.h"
+#include <arch/bsp/systimer.h>
+#include <arch/bsp/uart.h>
+#include <arch/cpu/scheduler.h>
+
+#define CAPTURE_SIZE 4096
+
+static char	    captured[CAPTURE_SIZE];
+static unsigned int captured_len = 0;
+
+void uart_putc(char input)
+{
+	// Wraps instead of overflowing, benchmarks print without resetting
+	if (captured_len == CAPTURE_SIZE - 1) {
+		captured_len = 0;
+	}
+	captured[captured_len++] = input;
+	captured[captured_len]	 = '\0';
+}
+
+void uart_puts(const char *string)
+{
+	while (*string) {
+		uart_putc(*string++);
+	}
+}
+
+void uart_write(const char *buf, uint32_t len)
+{
+	for (uint32_t i = 0; i < len; i++) {
+		uart_putc(buf[i]);
+	}
+}
+
+const char *uart_captured(void)
+{
+	return captured;
+}
+
+void uart_capture_reset(void)
+{
+	captured_len = 0;
+	captured[0]  = '\0';
+}
+
+static uint32_t random_state = 1;
+
+uint32_t host_random(void)
+{
+	random_state ^= random_state << 13;
+	random_state ^= random_state >> 17;
+	random_state ^= random_state << 5;
+	return random_state;
+}
+
+void host_random_seed(uint32_t seed)
+{
+	random_state = seed ? seed : 1;
+}
+
+/* Time stands still, the tests set exec_start relative to 0 */
+uint32_t systimer_now(void)
+{
+	return 0;
+}
+
+/* The policies look threads up by id, the tests own the table */
+static tcb_t thread_table[MAX_THREADS];
+
+tcb_t *scheduler_get_thread(int tid)
+{
+	return &thread_table[tid];
+}
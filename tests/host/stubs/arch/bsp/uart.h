@@ -0,0 +1,15 @@
+#ifndef UART_H
+#define UART_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/*
+ * Host stand-in for the PL011 driver. Output lands in a buffer the
+ * tests read back with uart_captured, see stubs.c.
+ */
+void uart_putc(char input);
+void uart_puts(const char *string);
+void uart_write(const char *buf, uint32_t len);
+
+#endif
@@ -0,0 +1,227 @@
+/*
+ * Unit and property tests of include/lib and lib/. The property tests
+ * run random operation sequences against a trivially correct model.
+ */
+#include "host.h"
+#include <lib/histogram.h>
+#include <lib/kprintf.h>
+#include <lib/list.h>
+#include <lib/ringbuffer.h>
+
+#define PROPERTY_ROUNDS 100000
+
+struct item {
+	list_node node;
+	int	  value;
+};
+
+void test_list(void)
+{
+	list_node   head;
+	struct item items[4];
+
+	list_init(&head);
+	CHECK(list_is_empty(&head));
+	CHECK(list_get_first(&head) == nullptr);
+	CHECK(list_remove_first(&head) == nullptr);
+
+	for (int i = 0; i < 4; i++) {
+		items[i].value = i;
+		list_add_last(&head, &items[i].node);
+	}
+	CHECK(list_entry(list_get_first(&head), struct item, node)->value == 0);
+	CHECK(list_entry(list_get_last(&head), struct item, node)->value == 3);
+
+	CHECK(list_remove(&head, &items[2].node) == &items[2].node);
+	CHECK(list_remove(&head, &items[2].node) == nullptr);
+	list_add_first(&head, &items[2].node);
+	CHECK(list_remove_first(&head) == &items[2].node);
+	CHECK(list_remove_last(&head) == &items[3].node);
+	CHECK(list_remove_first(&head) == &items[0].node);
+	CHECK(list_remove_first(&head) == &items[1].node);
+	CHECK(list_is_empty(&head));
+
+	// Property: a deque of 16 slots behaves like a model array
+	struct item pool[16];
+	int	    model[16];
+	int	    model_len = 0;
+	bool	    queued[16] = { false };
+
+	host_random_seed(0x1157);
+	for (int i = 0; i < 16; i++) {
+		pool[i].value = i;
+	}
+	for (int round = 0; round < PROPERTY_ROUNDS; round++) {
+		int v = (int)(host_random() % 16);
+		switch (host_random() % 3) {
+		case 0:
+			if (!queued[v]) {
+				list_add_last(&head, &pool[v].node);
+				model[model_len++] = v;
+				queued[v]	   = true;
+			}
+			break;
+		case 1:
+			if (!queued[v]) {
+				list_add_first(&head, &pool[v].node);
+				memmove(&model[1], &model[0], (size_t)model_len * sizeof(int));
+				model[0] = v;
+				model_len++;
+				queued[v] = true;
+			}
+			break;
+		default:
+			if (queued[v]) {
+				list_remove(&head, &pool[v].node);
+				int j = 0;
+				while (model[j] != v) {
+					j++;
+				}
+				memmove(&model[j], &model[j + 1],
+					(size_t)(model_len - j - 1) * sizeof(int));
+				model_len--;
+				queued[v] = false;
+			}
+			break;
+		}
+	}
+
+	int	   j  = 0;
+	bool	   ok = true;
+	list_node *curr;
+	for (curr = head.next; curr != &head; curr = curr->next) {
+		ok = ok && j < model_len && list_entry(curr, struct item, node)->value == model[j];
+		ok = ok && curr->next->prev == curr;
+		j++;
+	}
+	CHECK(ok && j == model_len);
+}
+
+create_ringbuffer(test_ring, 8);
+
+void test_ringbuffer(void)
+{
+	CHECK(buff_is_empty(test_ring));
+	CHECK(!buff_is_full(test_ring));
+
+	for (char c = 'a'; c < 'a' + 8; c++) {
+		CHECK(!buff_putc(test_ring, c));
+	}
+	CHECK(buff_is_full(test_ring));
+	CHECK(buff_putc(test_ring, 'z')); // full, rejected
+	CHECK(buff_peekc(test_ring) == 'a');
+	CHECK(buff_peekc_last(test_ring) == 'h');
+	for (char c = 'a'; c < 'a' + 8; c++) {
+		CHECK(buff_getc(test_ring) == c);
+	}
+	CHECK(buff_is_empty(test_ring));
+
+	// Property: FIFO order and fill level across many index wraps
+	char	     model[8];
+	unsigned int head = 0;
+	unsigned int len  = 0;
+	bool	     ok	  = true;
+
+	host_random_seed(0x2b);
+	for (int round = 0; round < PROPERTY_ROUNDS; round++) {
+		if (host_random() & 1) {
+			char c	    = (char)host_random();
+			bool failed = buff_putc(test_ring, c);
+			ok	    = ok && failed == (len == 8);
+			if (!failed) {
+				model[(head + len++) % 8] = c;
+			}
+		} else if (len) {
+			ok   = ok && buff_getc(test_ring) == model[head];
+			head = (head + 1) % 8;
+			len--;
+		}
+		ok = ok && buff_is_empty(test_ring) == (len == 0);
+		ok = ok && buff_is_full(test_ring) == (len == 8);
+	}
+	CHECK(ok);
+}
+
+#define CHECK_KPRINTF(expected, ...)                      \
+	do {                                              \
+		uart_capture_reset();                     \
+		kprintf(__VA_ARGS__);                     \
+		CHECK_STR(uart_captured(), (expected));   \
+	} while (0)
+
+void test_kprintf(void)
+{
+	CHECK_KPRINTF("plain", "plain");
+	CHECK_KPRINTF("c=x s=str %", "c=%c s=%s %%", 'x', "str");
+	CHECK_KPRINTF("0 42 -42", "%i %i %i", 0, 42, -42);
+	CHECK_KPRINTF("4294967295", "%u", 4294967295u);
+	CHECK_KPRINTF("ff deadbeef", "%x %x", 0xffu, 0xdeadbeefu);
+	CHECK_KPRINTF("   42|00042", "%5u|%05u", 42u, 42u);
+	CHECK_KPRINTF("0000beef", "%08x", 0xbeefu);
+	CHECK_KPRINTF("0x00001234", "%p", (void *)0x1234);
+}
+
+void test_mem(void)
+{
+	static unsigned char src[512];
+	static unsigned char dst[512];
+	static unsigned char ref[512];
+
+	host_random_seed(0x3e3);
+	for (int round = 0; round < PROPERTY_ROUNDS / 10; round++) {
+		for (size_t i = 0; i < sizeof(src); i++) {
+			src[i] = (unsigned char)host_random();
+		}
+		size_t off = host_random() % 64;
+		size_t n   = host_random() % (sizeof(src) - 64);
+
+		memset(dst, 0, sizeof(dst));
+		memset(ref, 0, sizeof(ref));
+		CHECK(kmem_memcpy(dst + off, src, n) == dst + off);
+		memcpy(ref + off, src, n);
+		CHECK(memcmp(dst, ref, sizeof(dst)) == 0);
+
+		// Overlapping in both directions
+		size_t shift = host_random() % 32;
+		memcpy(dst, src, sizeof(dst));
+		memcpy(ref, src, sizeof(ref));
+		kmem_memmove(dst + shift, dst, n);
+		memmove(ref + shift, ref, n);
+		CHECK(memcmp(dst, ref, sizeof(dst)) == 0);
+		kmem_memmove(dst, dst + shift, n);
+		memmove(ref, ref + shift, n);
+		CHECK(memcmp(dst, ref, sizeof(dst)) == 0);
+
+		int c = (int)(host_random() & 0xff);
+		kmem_memset(dst + off, c, n);
+		memset(ref + off, c, n);
+		CHECK(memcmp(dst, ref, sizeof(dst)) == 0);
+
+		int sign_k = kmem_memcmp(src, dst, n);
+		int sign_c = memcmp(src, dst, n);
+		CHECK((sign_k < 0) == (sign_c < 0) && (sign_k > 0) == (sign_c > 0));
+	}
+}
+
+void test_histogram(void)
+{
+	struct log2_hist hist;
+
+	hist_reset(&hist);
+	CHECK(hist_percentile(&hist, 99) == 0);
+
+	hist_record(&hist, 0);
+	for (uint32_t i = 1; i <= 98; i++) {
+		hist_record(&hist, 5); // bucket 4-7
+	}
+	hist_record(&hist, 1000); // bucket 512-1023
+	CHECK(hist.count == 100);
+	CHECK(hist.min == 0 && hist.max == 1000);
+	CHECK(hist.buckets[0] == 1 && hist.buckets[3] == 98 && hist.buckets[10] == 1);
+	CHECK(hist_percentile(&hist, 50) == 7);
+	CHECK(hist_percentile(&hist, 99) == 7);
+	CHECK(hist_percentile(&hist, 100) == 1000);
+
+	hist_record(&hist, UINT32_MAX); // clamps into the last bucket
+	CHECK(hist.buckets[HIST_BUCKETS - 1] == 1);
+}
@@ -0,0 +1,134 @@
+/*
+ * Pick-next logic of the round robin and fair policies, driven
+ * directly through their operations without the scheduler core.
+ */
+#include "host.h"
+#include <arch/cpu/scheduler.h>
+#include <kernel/kconfig.h>
+
+#define PROPERTY_ROUNDS 100000
+
+static void reset_threads(void)
+{
+	for (int i = 0; i < MAX_THREADS; i++) {
+		tcb_t *thread = scheduler_get_thread(i);
+		memset(thread, 0, sizeof(*thread));
+		thread->thread_id = (uint32_t)i;
+	}
+}
+
+static void test_rr(void)
+{
+	reset_threads();
+	sched_rr_init();
+	CHECK(sched_rr_pick_next() == nullptr);
+
+	// Continues above the last pick and wraps around
+	sched_rr_enqueue(scheduler_get_thread(3), false);
+	sched_rr_enqueue(scheduler_get_thread(7), false);
+	sched_rr_enqueue(scheduler_get_thread(31), false);
+	CHECK(sched_rr_pick_next() == scheduler_get_thread(3));
+	sched_rr_enqueue(scheduler_get_thread(1), false);
+	CHECK(sched_rr_pick_next() == scheduler_get_thread(7));
+	CHECK(sched_rr_pick_next() == scheduler_get_thread(31));
+	CHECK(sched_rr_pick_next() == scheduler_get_thread(1));
+	CHECK(sched_rr_pick_next() == nullptr);
+
+	sched_rr_enqueue(scheduler_get_thread(5), false);
+	sched_rr_dequeue(scheduler_get_thread(5));
+	CHECK(sched_rr_pick_next() == nullptr);
+
+	// Property: every ready thread is picked once per pass, none twice
+	host_random_seed(0x77);
+	bool ok = true;
+	for (int round = 0; round < PROPERTY_ROUNDS / 100; round++) {
+		uint32_t ready = host_random() & ~1u; // no idle thread
+		for (int i = 1; i < MAX_THREADS; i++) {
+			if (ready & (1u << i)) {
+				sched_rr_enqueue(scheduler_get_thread(i), false);
+			}
+		}
+		uint32_t picked = 0;
+		tcb_t	*next;
+		while ((next = sched_rr_pick_next())) {
+			ok = ok && !(picked & (1u << next->thread_id));
+			picked |= 1u << next->thread_id;
+		}
+		ok = ok && picked == ready;
+	}
+	CHECK(ok);
+}
+
+static void test_fair(void)
+{
+	reset_threads();
+	CHECK(sched_fair_pick_next() == nullptr);
+
+	for (int i = 1; i < MAX_THREADS; i++) {
+		sched_fair_init_thread(scheduler_get_thread(i));
+	}
+
+	// A heavier thread accrues virtual runtime slower
+	tcb_t *light = scheduler_get_thread(1);
+	tcb_t *heavy = scheduler_get_thread(2);
+	sched_fair_set_weight(heavy, 4 * SCHED_FAIR_WEIGHT_DEFAULT);
+	uint64_t light_start = light->fair.vruntime;
+	uint64_t heavy_start = heavy->fair.vruntime;
+	sched_fair_charge(light, 4000);
+	sched_fair_charge(heavy, 4000);
+	CHECK(light->fair.vruntime - light_start == 4000);
+	CHECK(heavy->fair.vruntime - heavy_start == 1000);
+	sched_fair_enqueue(light, false);
+	sched_fair_enqueue(heavy, false);
+	CHECK(sched_fair_pick_next() == heavy);
+	CHECK(sched_fair_pick_next() == light);
+	CHECK(sched_fair_pick_next() == nullptr);
+
+	// A woken thread preempts only with more than the granularity of lead
+	light->exec_start    = 0;
+	heavy->fair.vruntime = light->fair.vruntime - SCHED_FAIR_WAKEUP_GRANULARITY;
+	CHECK(!sched_fair_wakeup_preempt(light, heavy));
+	heavy->fair.vruntime--;
+	CHECK(sched_fair_wakeup_preempt(light, heavy));
+
+	// Property: pick_next always returns the smallest queued vruntime
+	host_random_seed(0xfa1);
+	bool ok = true;
+	for (int round = 0; round < PROPERTY_ROUNDS; round++) {
+		tcb_t *thread = scheduler_get_thread(1 + (int)(host_random() % (MAX_THREADS - 1)));
+		switch (host_random() % 3) {
+		case 0:
+			// Only the running thread is charged, never a queued one
+			if (thread->fair.heap_index < 0) {
+				sched_fair_charge(thread, host_random() % 10000);
+				sched_fair_enqueue(thread, host_random() & 1);
+			}
+			break;
+		case 1:
+			sched_fair_dequeue(thread);
+			break;
+		default: {
+			uint64_t min	= UINT64_MAX;
+			bool	 queued = false;
+			for (int i = 1; i < MAX_THREADS; i++) {
+				tcb_t *t = scheduler_get_thread(i);
+				if (t->fair.heap_index >= 0 && t->fair.vruntime < min) {
+					min    = t->fair.vruntime;
+					queued = true;
+				}
+			}
+			tcb_t *next = sched_fair_pick_next();
+			ok	    = ok && (queued ? next && next->fair.vruntime == min : !next);
+			ok	    = ok && (!next || next->fair.heap_index == -1);
+			break;
+		}
+		}
+	}
+	CHECK(ok);
+}
+
+void test_sched(void)
+{
+	test_rr();
+	test_fair();
+}
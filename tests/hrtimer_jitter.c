@@ -0,0 +1,70 @@
+/*
+ * Expiry jitter of periodic and one-shot hrtimers.
+ *
+ * Build with: make TSRC=tests/hrtimer_jitter.c qemu
+ *
+ * Jitter is the delay between the absolute deadline of a timer and
+ * the moment its callback runs. Periodic timers re-arm from their
+ * deadline, so a late callback does not shift later expirations.
+ */
+#include <arch/bsp/systimer.h>
+#include <arch/cpu/scheduler.h>
+#include <kernel/hrtimer.h>
+#include <lib/kprintf.h>
+
+#define MEASURE_US 2000000
+
+static uint32_t oneshot_delay[] = { 150, 2500, 40000, 333333 };
+
+static void nop_func(struct hrtimer *timer)
+{
+	(void)timer;
+}
+
+static void oneshot_func(struct hrtimer *timer)
+{
+	// Re-arm from the callback, the common one-shot pattern
+	static unsigned int next = 0;
+	next = (next + 1) % (sizeof(oneshot_delay) / sizeof(oneshot_delay[0]));
+	hrtimer_start(timer, oneshot_delay[next], 0);
+}
+
+static struct hrtimer periodic[] = {
+	HRTIMER_INIT(nop_func),
+	HRTIMER_INIT(nop_func),
+	HRTIMER_INIT(nop_func),
+};
+static uint32_t periodic_us[] = { 1000, 3300, 10000 };
+
+static struct hrtimer oneshot = HRTIMER_INIT(oneshot_func);
+
+static void jitter_thread(void *arg)
+{
+	(void)arg;
+
+	hrtimer_reset_stats();
+	for (unsigned int i = 0; i < sizeof(periodic) / sizeof(periodic[0]); i++) {
+		hrtimer_start(&periodic[i], periodic_us[i], periodic_us[i]);
+	}
+	hrtimer_start(&oneshot, oneshot_delay[0], 0);
+
+	uint32_t start = systimer_now();
+	while (systimer_now() - start < MEASURE_US) {
+		scheduler_yield();
+	}
+
+	for (unsigned int i = 0; i < sizeof(periodic) / sizeof(periodic[0]); i++) {
+		hrtimer_cancel(&periodic[i]);
+		kprintf("\nperiodic %u us: %u expirations, jitter max %u us", periodic_us[i],
+			periodic[i].expirations, periodic[i].jitter_max);
+	}
+	hrtimer_cancel(&oneshot);
+	kprintf("\none-shot: %u expirations, jitter max %u us\n", oneshot.expirations,
+		oneshot.jitter_max);
+	hrtimer_print_stats();
+}
+
+void test_kernel(void)
+{
+	scheduler_kthread_create(jitter_thread, nullptr);
+}
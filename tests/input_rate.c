@@ -0,0 +1,60 @@
+/*
+ * Input dispatch rate of the thread pool against a thread per key.
+ *
+ * Build with: tests/input_rate.sh (both INPUT_THREAD_POOL settings) or
+ * make TSRC=tests/input_rate.c qemu
+ *
+ * A kernel thread posts keys for one fixed burst window, yielding after
+ * each so the threads that take them can run. main() only ends its
+ * thread or, in a pool worker, goes back to sys_input_wait(), so the
+ * rate is what the dispatch alone sustains. The rate counts every key
+ * handed to main() inside the window, keys still queued at its end are
+ * left out.
+ */
+#include <arch/bsp/systimer.h>
+#include <arch/cpu/scheduler.h>
+#include <kernel/input_pool.h>
+#include <kernel/kconfig.h>
+#include <lib/kprintf.h>
+#include <user/syscall.h>
+
+#define BURST_US 1000000
+
+static void rate_thread(void *arg)
+{
+	(void)arg;
+
+	struct input_stats before, after;
+	input_get_stats(&before);
+
+	uint32_t sent  = 0;
+	uint32_t start = systimer_now();
+	while (systimer_now() - start < BURST_US) {
+		input_event_post('.');
+		sent++;
+		scheduler_yield();
+	}
+	input_get_stats(&after);
+
+	uint32_t processed = after.processed - before.processed;
+	kprintf("\ninput_rate design=%s sent=%u processed=%u dropped=%u chars_per_s=%u\n",
+		INPUT_THREAD_POOL ? "pool" : "thread_per_key", sent, processed,
+		after.dropped - before.dropped, processed * (1000000 / BURST_US));
+}
+
+/* A pool worker keeps taking keys right here, a key thread ends */
+void test_user(void *args)
+{
+	(void)args;
+	if (!INPUT_THREAD_POOL) {
+		sys_exit();
+	}
+	while (true) {
+		sys_input_wait();
+	}
+}
+
+void test_kernel(void)
+{
+	scheduler_kthread_create(rate_thread, nullptr);
+}
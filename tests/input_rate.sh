@@ -0,0 +1,12 @@
+#!/bin/sh
+# Builds tests/input_rate.c once with a thread per key and once with the
+# worker pool and collects the result lines. QEMU does not exit on its
+# own, every run is cut off after RUN_SECONDS.
+RUN_SECONDS=${RUN_SECONDS:-30}
+
+for pool in false true; do
+	make clean > /dev/null
+	timeout "$RUN_SECONDS" make TSRC=tests/input_rate.c \
+		CFLAGS="-std=gnu23 -DINPUT_THREAD_POOL_SELECT=$pool" qemu 2>&1 |
+		grep -a '^input_rate'
+done
@@ -0,0 +1,128 @@
+/*
+ * Latency of the register based IPC against a message ring in shared
+ * memory whose consumer is woken up through a semaphore.
+ *
+ * Build with: make TSRC=tests/ipc_bench.c qemu
+ *
+ * The server is created first, so it already waits in receive when the
+ * client sends and the kernel switches straight to it. One-way latency
+ * is measured by the server from a cycle stamp in the message, the
+ * round trip by the client around call/reply. The semaphore round trip
+ * is the post/wait pair a queue based server needs per request.
+ */
+#include <arch/cpu/pmu.h>
+#include <arch/cpu/scheduler.h>
+#include <kernel/ipc.h>
+#include <lib/kprintf.h>
+#include <user/ipc.h>
+#include <user/sync.h>
+
+#define ROUNDS	  1000
+#define RING_SIZE 8
+
+struct latency {
+	uint32_t total;
+	uint32_t max;
+};
+
+static sem_t ring_items = SEM_INIT(0);
+static sem_t ring_slots = SEM_INIT(RING_SIZE);
+static sem_t request	= SEM_INIT(0);
+static sem_t response	= SEM_INIT(0);
+static struct ipc_msg ring[RING_SIZE];
+
+static struct latency ipc_one_way;
+static struct latency ring_one_way;
+
+static void record(struct latency *lat, uint32_t cycles)
+{
+	lat->total += cycles;
+	if (cycles > lat->max) {
+		lat->max = cycles;
+	}
+}
+
+static void print(const char *name, const struct latency *lat)
+{
+	kprintf("ipc_bench %s_avg_cycles=%u %s_max_cycles=%u\n", name, lat->total / ROUNDS, name,
+		lat->max);
+}
+
+static void server_thread(void *arg)
+{
+	(void)arg;
+	struct ipc_msg msg;
+
+	for (unsigned int i = 0; i < ROUNDS; i++) {
+		ipc_receive(IPC_ANY, &msg);
+		record(&ipc_one_way, pmu_cycles() - msg.w[0]);
+	}
+
+	for (unsigned int i = 0; i < ROUNDS; i++) {
+		sem_wait(&ring_items);
+		record(&ring_one_way, pmu_cycles() - ring[i % RING_SIZE].w[0]);
+		sem_post(&ring_slots);
+	}
+
+	for (unsigned int i = 0; i < ROUNDS; i++) {
+		sem_wait(&request);
+		sem_post(&response);
+	}
+
+	// Echo server: returns the message with the first word incremented
+	int client = ipc_receive(IPC_ANY, &msg);
+	while (client >= 0) {
+		msg.w[0]++;
+		client = ipc_reply_receive((uint32_t)client, &msg, IPC_ANY);
+	}
+}
+
+static void client_thread(void *arg)
+{
+	uint32_t server = *(const uint32_t *)arg;
+	struct ipc_msg msg = { 0 };
+
+	for (unsigned int i = 0; i < ROUNDS; i++) {
+		msg.w[0] = pmu_cycles();
+		ipc_send(server, &msg);
+	}
+
+	for (unsigned int i = 0; i < ROUNDS; i++) {
+		sem_wait(&ring_slots);
+		ring[i % RING_SIZE].w[0] = pmu_cycles();
+		sem_post(&ring_items);
+	}
+
+	// Round trip over semaphores, one each way
+	struct latency ring_call = { 0 };
+	for (unsigned int i = 0; i < ROUNDS; i++) {
+		uint32_t start = pmu_cycles();
+		sem_post(&request);
+		sem_wait(&response);
+		record(&ring_call, pmu_cycles() - start);
+	}
+
+	struct latency call = { 0 };
+	bool	       ok   = true;
+	for (unsigned int i = 0; i < ROUNDS; i++) {
+		msg.w[0]       = i;
+		uint32_t start = pmu_cycles();
+		int	 ret   = ipc_call(server, &msg);
+		record(&call, pmu_cycles() - start);
+		ok = ok && ret == 0 && msg.w[0] == i + 1;
+	}
+
+	kprintf("\n");
+	print("ipc_one_way", &ipc_one_way);
+	print("ring_one_way", &ring_one_way);
+	print("ipc_round_trip", &call);
+	print("ring_round_trip", &ring_call);
+	kprintf("ipc_bench echo=%s\n", ok ? "ok" : "FAILED");
+	ipc_print_stats();
+}
+
+void test_kernel(void)
+{
+	uint32_t server = (uint32_t)scheduler_thread_create(server_thread, nullptr, 0);
+	scheduler_thread_create(client_thread, &server, sizeof(server));
+}
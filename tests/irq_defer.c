@@ -0,0 +1,106 @@
+/*
+ * Longest IRQ dispatch with the per-key work done in the handler
+ * against the same work deferred to the kernel worker.
+ *
+ * Build with: make TSRC=tests/irq_defer.c qemu
+ *
+ * A mailbox IRQ stands in for a received key. In the in-IRQ pass its
+ * handler creates the thread for the key itself, like the UART handler
+ * did before the work queue. In the deferred pass the handler only
+ * queues a work item that creates the thread. Both passes print the
+ * longest dispatch of irq_controller_dispatch() in cycles, the time
+ * IRQs stay off per IRQ.
+ */
+#include <arch/bsp/irq_controller.h>
+#include <arch/cpu/scheduler.h>
+#include <kernel/workqueue.h>
+#include <lib/kprintf.h>
+#include <user/main.h>
+#include <user/syscall.h>
+
+#define EVENTS 200
+
+static volatile uint32_t events_done = 0;
+static bool		 defer	     = false;
+
+static void key_thread_exit(tcb_t *thread)
+{
+	(void)thread;
+	events_done++;
+}
+
+/* The processing of one key, what the work item and the old handler do */
+static void process_key(void)
+{
+	char c	= '.';
+	int  tid = scheduler_thread_create(main, &c, sizeof(c));
+	if (tid < 0) {
+		events_done++;
+		return;
+	}
+	scheduler_set_exit_hook(tid, key_thread_exit);
+}
+
+static void key_work_func(struct work *work)
+{
+	(void)work;
+	// The new thread must not run before its exit hook is set
+	preempt_disable();
+	process_key();
+	preempt_enable();
+}
+
+static struct work key_work = WORK_INIT(key_work, key_work_func);
+
+static void key_irq_handler(void *ctx)
+{
+	(void)ctx;
+	if (defer) {
+		schedule_work(&key_work);
+	} else {
+		process_key();
+	}
+}
+
+static uint32_t measure(bool deferred)
+{
+	defer	    = deferred;
+	events_done = 0;
+	irq_controller_dispatch_max_reset();
+
+	for (uint32_t i = 0; i < EVENTS; i++) {
+		irq_controller_raise_mailbox(1);
+		while (events_done <= i) {
+			scheduler_yield();
+		}
+	}
+	return irq_controller_dispatch_max_reset();
+}
+
+static void defer_thread(void *arg)
+{
+	(void)arg;
+
+	if (request_irq(IRQ_LOCAL_MAILBOX1, key_irq_handler, nullptr) < 0) {
+		kprintf("\nirq_defer error=mailbox_taken\n");
+		return;
+	}
+	uint32_t in_irq	  = measure(false);
+	uint32_t deferred = measure(true);
+	free_irq(IRQ_LOCAL_MAILBOX1);
+
+	kprintf("\nirq_defer events=%u in_irq_dispatch_max=%u deferred_dispatch_max=%u\n", EVENTS,
+		in_irq, deferred);
+}
+
+/* Every key thread ends right away, main() would print the key */
+void test_user(void *args)
+{
+	(void)args;
+	sys_exit();
+}
+
+void test_kernel(void)
+{
+	scheduler_kthread_create(defer_thread, nullptr);
+}
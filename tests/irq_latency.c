@@ -0,0 +1,72 @@
+/*
+ * Worst-case timer IRQ latency while a long kernel operation is running.
+ *
+ * Build with: make TSRC=tests/irq_latency.c qemu
+ *
+ * The same operation runs once preemptible (IRQs enabled on its own
+ * kernel stack) and once inside an IRQ-off section, like every kernel
+ * path did before per-thread kernel stacks. The latency is the worst
+ * delay of a periodic probe hrtimer behind its deadline, so a pass takes
+ * MEASURE_US whatever TIMER_INTERVAL the test setup uses.
+ */
+#include <arch/bsp/systimer.h>
+#include <arch/cpu/irq_flags.h>
+#include <arch/cpu/scheduler.h>
+#include <kernel/hrtimer.h>
+#include <lib/kprintf.h>
+#include <lib/mem.h>
+
+#define LONG_OP_BUFFER_SIZE (16 * 1024)
+#define MEASURE_US	    2000000
+#define PROBE_PERIOD_US	    1000
+
+static void probe_func(struct hrtimer *timer)
+{
+	(void)timer;
+}
+
+static char	      long_op_buffer[LONG_OP_BUFFER_SIZE];
+static struct hrtimer probe = HRTIMER_INIT(probe_func);
+
+static void long_kernel_op(void)
+{
+	for (unsigned int i = 0; i < 8; i++) {
+		memset(long_op_buffer, (int)i, sizeof(long_op_buffer));
+	}
+}
+
+static uint32_t measure(bool irqs_off)
+{
+	probe.jitter_max = 0;
+	hrtimer_start(&probe, PROBE_PERIOD_US, PROBE_PERIOD_US);
+
+	uint32_t start = systimer_now();
+	while (systimer_now() - start < MEASURE_US) {
+		uint32_t flags = 0;
+		if (irqs_off) {
+			flags = local_irq_save();
+		}
+		long_kernel_op();
+		if (irqs_off) {
+			local_irq_restore(flags);
+		}
+	}
+
+	hrtimer_cancel(&probe);
+	return probe.jitter_max;
+}
+
+static void latency_thread(void *arg)
+{
+	(void)arg;
+
+	uint32_t preemptible = measure(false);
+	uint32_t irqs_off    = measure(true);
+
+	kprintf("\nirq latency max: preemptible %u us, irqs off %u us\n", preemptible, irqs_off);
+}
+
+void test_kernel(void)
+{
+	scheduler_kthread_create(latency_thread, nullptr);
+}
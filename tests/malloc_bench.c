@@ -0,0 +1,135 @@
+/*
+ * Allocation throughput and fragmentation of the user heap.
+ *
+ * Build with: make TSRC=tests/malloc_bench.c qemu
+ *
+ * Throughput: several threads allocate batches of small objects and
+ * free them again, most operations should hit the thread cache. The
+ * kernel stats show how few sbrk calls that takes.
+ *
+ * Fragmentation: one thread keeps a set of live blocks of random sizes
+ * and replaces random ones over and over. At the end the requested
+ * bytes are compared to what the heap took from the kernel. Once every
+ * block is freed, merged large runs at the top go back to the kernel.
+ */
+#include <arch/bsp/systimer.h>
+#include <arch/cpu/scheduler.h>
+#include <kernel/pages.h>
+#include <lib/kprintf.h>
+#include <user/malloc.h>
+#include <user/sync.h>
+
+#define THREADS	      3
+#define BATCHES	      100
+#define BATCH	      32
+#define SLOTS	      256
+#define REPLACEMENTS  4000
+#define MAX_SMALL     512
+#define MAX_LARGE     6000
+#define LARGE_PERCENT 5
+
+static sem_t done = SEM_INIT(0);
+
+static void   *slots[SLOTS];
+static uint32_t slot_size[SLOTS];
+
+static uint32_t xorshift(uint32_t *state)
+{
+	uint32_t x = *state;
+	x ^= x << 13;
+	x ^= x >> 17;
+	x ^= x << 5;
+	*state = x;
+	return x;
+}
+
+static uint32_t random_size(uint32_t *state)
+{
+	if (xorshift(state) % 100 < LARGE_PERCENT) {
+		return 1 + xorshift(state) % MAX_LARGE;
+	}
+	return 1 + xorshift(state) % MAX_SMALL;
+}
+
+static void throughput_thread(void *arg)
+{
+	uint32_t seed = *(const uint32_t *)arg;
+	void	*batch[BATCH];
+	bool	 ok = true;
+
+	for (unsigned int b = 0; b < BATCHES; b++) {
+		for (unsigned int i = 0; i < BATCH; i++) {
+			uint32_t size = 1 + xorshift(&seed) % MAX_SMALL;
+			batch[i]      = malloc(size);
+			ok	      = ok && batch[i];
+			if (batch[i]) {
+				*(uint8_t *)batch[i] = (uint8_t)i;
+			}
+		}
+		for (unsigned int i = 0; i < BATCH; i++) {
+			ok = ok && (!batch[i] || *(uint8_t *)batch[i] == (uint8_t)i);
+			free(batch[i]);
+		}
+	}
+
+	if (!ok) {
+		kprintf("malloc_bench thread %u: allocation failed or corrupted\n", seed);
+	}
+	sem_post(&done);
+}
+
+static void bench_thread(void *arg)
+{
+	(void)arg;
+
+	uint32_t start = systimer_now();
+	for (uint32_t i = 1; i <= THREADS; i++) {
+		scheduler_thread_create(throughput_thread, &i, sizeof(i));
+	}
+	for (unsigned int i = 0; i < THREADS; i++) {
+		sem_wait(&done);
+	}
+	uint32_t us  = systimer_now() - start;
+	uint32_t ops = THREADS * BATCHES * BATCH;
+
+	kprintf("\nmalloc_bench threads=%u malloc_free_pairs=%u ns_per_pair=%u\n", THREADS, ops,
+		us * 10 / (ops / 100));
+	pages_print_stats();
+
+	uint32_t seed	   = 42;
+	uint32_t requested = 0;
+	for (unsigned int i = 0; i < SLOTS; i++) {
+		slot_size[i] = random_size(&seed);
+		slots[i]     = malloc(slot_size[i]);
+		requested += slot_size[i];
+	}
+	for (unsigned int r = 0; r < REPLACEMENTS; r++) {
+		unsigned int i = xorshift(&seed) % SLOTS;
+		free(slots[i]);
+		requested -= slot_size[i];
+		slot_size[i] = random_size(&seed);
+		slots[i]     = malloc(slot_size[i]);
+		requested += slot_size[i];
+	}
+
+	struct malloc_stats stats;
+	malloc_get_stats(&stats);
+	kprintf("malloc_bench requested=%u in_use=%u cached=%u shared_free=%u heap=%u "
+		"utilization_permille=%u\n",
+		requested, stats.in_use_bytes, stats.cached_bytes, stats.shared_bytes,
+		stats.heap_bytes, requested / (stats.heap_bytes / 1000));
+	pages_print_stats();
+
+	for (unsigned int i = 0; i < SLOTS; i++) {
+		free(slots[i]);
+	}
+	uint32_t heap_before = stats.heap_bytes;
+	malloc_get_stats(&stats);
+	kprintf("malloc_bench heap_before_free=%u heap_after_free=%u\n", heap_before,
+		stats.heap_bytes);
+}
+
+void test_kernel(void)
+{
+	scheduler_thread_create(bench_thread, nullptr, 0);
+}
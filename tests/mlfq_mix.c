@@ -0,0 +1,131 @@
+/*
+ * Context switches and wake-up latency on a mixed workload.
+ *
+ * Build with: make TSRC=tests/mlfq_mix.c qemu
+ *
+ * CPU bound threads run next to "keystroke" threads that are woken by
+ * an hrtimer and do a little work each time. The latency is the delay
+ * between the wake-up and the thread actually running. For round robin
+ * and fair a 10 ms hrtimer stands in for the global quantum, MLFQ uses
+ * its own per level quanta. Run once per SCHED_POLICY (kconfig.h).
+ */
+#include <arch/bsp/systimer.h>
+#include <arch/cpu/irq_flags.h>
+#include <arch/cpu/scheduler.h>
+#include <kernel/hrtimer.h>
+#include <kernel/kconfig.h>
+#include <kernel/wait.h>
+#include <lib/kprintf.h>
+
+#define BUSY_THREADS	  3
+#define KEY_THREADS	  2
+#define KEY_WORK_US	  200
+#define GLOBAL_QUANTUM_US 10000
+#define MEASURE_US	  1000000
+
+struct key_thread {
+	struct hrtimer timer;
+	wait_queue_t   wait;
+	uint32_t       period;
+	uint32_t       woken_at;
+	uint32_t       wakeups;
+	uint32_t       latency_max;
+	uint32_t       latency_total;
+};
+
+static void key_func(struct hrtimer *timer);
+
+static struct key_thread keys[KEY_THREADS] = {
+	{ .timer = HRTIMER_INIT(key_func), .period = 7000 },
+	{ .timer = HRTIMER_INIT(key_func), .period = 13000 },
+};
+
+static volatile bool stop = false;
+
+static void key_func(struct hrtimer *timer)
+{
+	struct key_thread *key = list_entry(timer, struct key_thread, timer);
+	key->woken_at	       = systimer_now();
+	wake_up(&key->wait);
+}
+
+static void quantum_func(struct hrtimer *timer)
+{
+	(void)timer;
+	scheduler_need_resched();
+}
+
+static struct hrtimer quantum_timer = HRTIMER_INIT(quantum_func);
+
+static void busy_thread(void *arg)
+{
+	(void)arg;
+	while (!stop) {
+	}
+}
+
+static void key_thread(void *arg)
+{
+	struct key_thread *key = arg;
+
+	while (!stop) {
+		uint32_t flags = local_irq_save();
+		wait_queue_sleep(&key->wait);
+		local_irq_restore(flags);
+
+		uint32_t latency = systimer_now() - key->woken_at;
+		key->wakeups++;
+		key->latency_total += latency;
+		if (latency > key->latency_max) {
+			key->latency_max = latency;
+		}
+
+		uint32_t start = systimer_now();
+		while (systimer_now() - start < KEY_WORK_US) {
+		}
+	}
+}
+
+static void report_thread(void *arg)
+{
+	(void)arg;
+
+	sched_rt_set(scheduler_get_current_thread(), 100, MEASURE_US, MEASURE_US);
+	scheduler_reset_stats();
+	if (SCHED_POLICY != SCHED_POLICY_MLFQ) {
+		hrtimer_start(&quantum_timer, GLOBAL_QUANTUM_US, GLOBAL_QUANTUM_US);
+	}
+	for (unsigned int i = 0; i < KEY_THREADS; i++) {
+		hrtimer_start(&keys[i].timer, keys[i].period, keys[i].period);
+	}
+	sched_rt_wait_period();
+
+	hrtimer_cancel(&quantum_timer);
+	for (unsigned int i = 0; i < KEY_THREADS; i++) {
+		hrtimer_cancel(&keys[i].timer);
+	}
+	stop = true;
+
+	kprintf("\npolicy %s\n", SCHED_POLICY == SCHED_POLICY_MLFQ ? "mlfq" :
+				 SCHED_POLICY == SCHED_POLICY_FAIR ? "fair" :
+								     "round robin");
+	for (unsigned int i = 0; i < KEY_THREADS; i++) {
+		struct key_thread *key = &keys[i];
+		kprintf("keys every %u us: %u wake-ups, latency avg %u us max %u us\n", key->period,
+			key->wakeups, key->wakeups ? key->latency_total / key->wakeups : 0,
+			key->latency_max);
+	}
+	scheduler_print_stats();
+}
+
+void test_kernel(void)
+{
+	scheduler_kthread_create(report_thread, nullptr);
+	for (unsigned int i = 0; i < KEY_THREADS; i++) {
+		wait_queue_init(&keys[i].wait);
+		scheduler_kthread_create(key_thread, &keys[i]);
+	}
+	for (unsigned int i = 0; i < BUSY_THREADS; i++) {
+		scheduler_kthread_create(busy_thread, nullptr);
+	}
+}
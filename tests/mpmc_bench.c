@@ -0,0 +1,137 @@
+/*
+ * Throughput of the lock-free MPMC queue with 1:1, N:1 and N:M
+ * producers and consumers.
+ *
+ * Build with: make TSRC=tests/mpmc_bench.c qemu
+ *
+ * Producers fill buffers from a pool and pass them by pointer, the
+ * consumers check and sum them. Every setup moves the same number of
+ * buffers through a queue much smaller than that, so producers and
+ * consumers keep blocking on each other. Consumers stop on a nullptr,
+ * one per consumer is pushed after all producers are done.
+ */
+#include <arch/bsp/systimer.h>
+#include <arch/cpu/scheduler.h>
+#include <kernel/futex.h>
+#include <lib/atomic.h>
+#include <lib/kprintf.h>
+#include <user/mpmc.h>
+#include <user/sync.h>
+
+#define QUEUE_SIZE    16
+#define BUFFERS	      4096
+#define BUFFER_WORDS  64
+#define MAX_PRODUCERS 4
+#define MAX_CONSUMERS 4
+
+struct setup {
+	const char  *name;
+	unsigned int producers;
+	unsigned int consumers;
+};
+
+static const struct setup setups[] = {
+	{ "1:1", 1, 1 },
+	{ "N:1", 3, 1 },
+	{ "N:M", 3, 3 },
+};
+
+static struct mpmc_cell	 cells[QUEUE_SIZE];
+static struct mpmc_queue queue;
+static uint32_t		 buffers[BUFFERS][BUFFER_WORDS];
+
+static const struct setup *current;
+static sem_t		   start_producer[MAX_PRODUCERS]; // all SEM_INIT(0)
+static sem_t		   start_consumers = SEM_INIT(0);
+static sem_t		   producers_done  = SEM_INIT(0);
+static sem_t		   consumers_done  = SEM_INIT(0);
+static volatile uint32_t   received	   = 0;
+static volatile uint32_t   corrupt	   = 0;
+
+static void producer_thread(void *arg)
+{
+	unsigned int id = *(const unsigned int *)arg;
+
+	for (;;) {
+		sem_wait(&start_producer[id]);
+		unsigned int count = BUFFERS / current->producers;
+
+		for (unsigned int i = id * count; i < (id + 1) * count; i++) {
+			for (unsigned int w = 0; w < BUFFER_WORDS; w++) {
+				buffers[i][w] = i + w;
+			}
+			mpmc_push(&queue, buffers[i]);
+		}
+		sem_post(&producers_done);
+	}
+}
+
+static void consumer_thread(void *arg)
+{
+	(void)arg;
+
+	for (;;) {
+		sem_wait(&start_consumers);
+
+		uint32_t *buffer;
+		while ((buffer = mpmc_pop(&queue))) {
+			uint32_t index = buffer[0];
+			if (buffer[BUFFER_WORDS - 1] != index + BUFFER_WORDS - 1) {
+				atomic_add_return(&corrupt, 1);
+			}
+			atomic_add_return(&received, 1);
+		}
+		sem_post(&consumers_done);
+	}
+}
+
+static void bench_thread(void *arg)
+{
+	(void)arg;
+	kprintf("\n");
+
+	for (unsigned int s = 0; s < sizeof(setups) / sizeof(setups[0]); s++) {
+		current	 = &setups[s];
+		received = 0;
+		corrupt	 = 0;
+		mpmc_init(&queue, cells, QUEUE_SIZE);
+
+		uint32_t start = systimer_now();
+		for (unsigned int i = 0; i < current->consumers; i++) {
+			sem_post(&start_consumers);
+		}
+		for (unsigned int i = 0; i < current->producers; i++) {
+			sem_post(&start_producer[i]);
+		}
+		for (unsigned int i = 0; i < current->producers; i++) {
+			sem_wait(&producers_done);
+		}
+		for (unsigned int i = 0; i < current->consumers; i++) {
+			mpmc_push(&queue, nullptr);
+		}
+		for (unsigned int i = 0; i < current->consumers; i++) {
+			sem_wait(&consumers_done);
+		}
+		uint32_t us = systimer_now() - start;
+		uint32_t ms = us / 1000;
+
+		uint32_t expected = BUFFERS / current->producers * current->producers;
+		kprintf("mpmc_bench setup=%s producers=%u consumers=%u buffers=%u us=%u "
+			"buffers_per_s=%u ok=%s\n",
+			current->name, current->producers, current->consumers, received, us,
+			ms ? received * 1000 / ms : 0,
+			received == expected && corrupt == 0 ? "yes" : "NO");
+	}
+	futex_print_stats();
+}
+
+void test_kernel(void)
+{
+	scheduler_thread_create(bench_thread, nullptr, 0);
+	for (unsigned int i = 0; i < MAX_PRODUCERS; i++) {
+		scheduler_thread_create(producer_thread, &i, sizeof(i));
+	}
+	for (unsigned int i = 0; i < MAX_CONSUMERS; i++) {
+		scheduler_thread_create(consumer_thread, nullptr, 0);
+	}
+}
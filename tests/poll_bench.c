@@ -0,0 +1,125 @@
+/*
+ * Wake-up latency of sys_poll for timer and IPC events, and the CPU
+ * time a waiting thread burns compared with polling in a loop.
+ *
+ * Build with: make TSRC=tests/poll_bench.c qemu
+ *
+ * 1. timeout: the poller waits for a timeout, lateness is the time
+ *    behind the requested expiry
+ * 2. busy: the same waits done by checking the time and yielding, the
+ *    way a thread has to wait for uart_data_available without poll
+ * 3. ipc: a sender queues a stamped message every few hundred µs, the
+ *    poller waits for POLL_IPC and receives it
+ *
+ * CPU usage is the share of the wall time the poller ran, taken from
+ * its exec_total.
+ */
+#include <arch/bsp/systimer.h>
+#include <arch/cpu/scheduler.h>
+#include <kernel/poll.h>
+#include <lib/kprintf.h>
+#include <user/ipc.h>
+#include <user/poll.h>
+#include <user/syscall.h>
+
+#define ROUNDS	    100
+#define WAIT_US	    1000
+#define SEND_GAP_US 500
+
+struct result {
+	uint32_t latency_total;
+	uint32_t latency_max;
+	uint32_t cpu_permille;
+};
+
+static void record(struct result *res, uint32_t latency)
+{
+	res->latency_total += latency;
+	if (latency > res->latency_max) {
+		res->latency_max = latency;
+	}
+}
+
+static void print(const char *name, const struct result *res)
+{
+	kprintf("poll_bench %s_latency_avg_us=%u %s_latency_max_us=%u %s_cpu_permille=%u\n", name,
+		res->latency_total / ROUNDS, name, res->latency_max, name, res->cpu_permille);
+}
+
+static uint32_t exec_us(void)
+{
+	return (uint32_t)scheduler_get_current_thread()->exec_total;
+}
+
+/* Share of the wall time since start the current thread ran */
+static uint32_t cpu_permille(uint32_t start, uint32_t exec_start)
+{
+	uint32_t wall = systimer_now() - start;
+	uint32_t exec = exec_us() - exec_start;
+	return wall >= 1000 ? exec / (wall / 1000) : 0;
+}
+
+static void sender_thread(void *arg)
+{
+	uint32_t       poller = *(const uint32_t *)arg;
+	struct ipc_msg msg    = { 0 };
+
+	for (unsigned int i = 0; i < ROUNDS; i++) {
+		sys_poll(0, SEND_GAP_US);
+		msg.w[0] = systimer_now();
+		ipc_send(poller, &msg);
+	}
+}
+
+static void poller_thread(void *arg)
+{
+	(void)arg;
+	struct result timeout = { 0 };
+	struct result busy    = { 0 };
+	struct result ipc     = { 0 };
+
+	uint32_t start	    = systimer_now();
+	uint32_t exec_start = exec_us();
+	for (unsigned int i = 0; i < ROUNDS; i++) {
+		uint32_t before = systimer_now();
+		sys_poll(0, WAIT_US);
+		record(&timeout, systimer_now() - before - WAIT_US);
+	}
+	timeout.cpu_permille = cpu_permille(start, exec_start);
+
+	start	   = systimer_now();
+	exec_start = exec_us();
+	for (unsigned int i = 0; i < ROUNDS; i++) {
+		uint32_t before = systimer_now();
+		while (systimer_now() - before < WAIT_US) {
+			sys_yield();
+		}
+		record(&busy, systimer_now() - before - WAIT_US);
+	}
+	busy.cpu_permille = cpu_permille(start, exec_start);
+
+	uint32_t self = (uint32_t)scheduler_get_current_thread()->thread_id;
+	scheduler_thread_create(sender_thread, &self, sizeof(self));
+
+	start	   = systimer_now();
+	exec_start = exec_us();
+	for (unsigned int i = 0; i < ROUNDS; i++) {
+		struct ipc_msg msg;
+		sys_poll(POLL_IPC, POLL_FOREVER);
+		uint32_t woken = systimer_now();
+		ipc_receive(IPC_ANY, &msg);
+		record(&ipc, woken - msg.w[0]);
+	}
+	ipc.cpu_permille = cpu_permille(start, exec_start);
+
+	kprintf("\n");
+	print("timeout", &timeout);
+	print("busy", &busy);
+	print("ipc", &ipc);
+	poll_print_stats();
+}
+
+void test_kernel(void)
+{
+	scheduler_thread_create(poller_thread, nullptr, 0);
+}
@@ -0,0 +1,52 @@
+#!/bin/sh
+# Symbolizes the samples of the sampling profiler (kernel/profile.c)
+# against the kernel image. Set PROFILE_SAMPLING and UART_DEBUG_KEYS in
+# kernel/kconfig.h, save the QEMU output and press 'R' to dump the buffer:
+#
+#   make qemu | tee qemu.log
+#   tests/profile.sh qemu.log
+#
+# Prints a flat profile, samples per function with the most first, and
+# writes the folded stacks "mode;tid;caller;function count" that
+# flamegraph.pl takes to FOLDED. The caller comes from the interrupted
+# lr, which is only right while the sampled function has not reused it.
+LOG=${1:?usage: $0 <qemu log>}
+ELF=${ELF:-build/kernel.elf}
+ADDR2LINE=${ADDR2LINE:-${PREFIX:-$HOME/arm}/bin/arm-none-eabi-addr2line}
+FOLDED=${FOLDED:-profile.folded}
+
+addrs=$(mktemp)
+symbols=$(mktemp)
+trap 'rm -f "$addrs" "$symbols"' EXIT
+
+# Every pc and lr once, then one "address function" line for each
+grep '^profile_sample ' "$LOG" | tr ' =' '\n\n' |
+	awk 'prev == "pc" || prev == "lr" { print } { prev = $0 }' | sort -u > "$addrs"
+"$ADDR2LINE" -f -s -e "$ELF" < "$addrs" | paste -d ' ' - - | cut -d ' ' -f 1 |
+	paste -d ' ' "$addrs" - > "$symbols"
+
+awk -v folded="$FOLDED" '
+	FNR == NR { name[$1] = $2; next }
+	/^profile_sample / {
+		for (i = 2; i <= NF; i++) {
+			split($i, kv, "=")
+			field[kv[1]] = kv[2]
+		}
+		fn = name[field["pc"]]
+		caller = name[field["lr"]]
+		flat[fn]++
+		stack[field["mode"] ";tid" field["tid"] ";" caller ";" fn]++
+		total++
+	}
+	END {
+		if (!total) {
+			print "no profile_sample lines found"
+			exit 1
+		}
+		for (fn in flat) {
+			printf "%8u %5.1f%% %s\n", flat[fn], 100 * flat[fn] / total, fn
+		}
+		for (s in stack) {
+			print s, stack[s] > folded
+		}
+	}' "$symbols" "$LOG" | sort -rn
@@ -0,0 +1,61 @@
+/*
+ * Runs a known workload under the sampling profiler and dumps the
+ * samples, as input for tests/profile.sh.
+ *
+ * Build with: make TSRC=tests/profile_run.c qemu | tee qemu.log
+ *
+ * The user thread spends three times as long in spin_long as in
+ * spin_short, the flat profile should show about that ratio.
+ */
+#include <arch/cpu/scheduler.h>
+#include <kernel/profile.h>
+#include <kernel/wait.h>
+#include <lib/kprintf.h>
+
+#define SPIN_ROUNDS 2000000
+
+static wait_queue_t done_wq = WAIT_QUEUE_INIT(done_wq);
+static volatile bool workload_done;
+
+[[gnu::noinline]] static void spin_short(void)
+{
+	for (volatile unsigned int i = 0; i < SPIN_ROUNDS; i++) {
+	}
+}
+
+[[gnu::noinline]] static void spin_long(void)
+{
+	for (volatile unsigned int i = 0; i < 3 * SPIN_ROUNDS; i++) {
+	}
+}
+
+static void workload_thread(void *arg)
+{
+	(void)arg;
+	spin_short();
+	spin_long();
+}
+
+static void workload_exited(tcb_t *thread)
+{
+	(void)thread;
+	workload_done = true;
+	wake_up(&done_wq);
+}
+
+static void report_thread(void *arg)
+{
+	(void)arg;
+	wait_event(&done_wq, workload_done);
+	profile_stop();
+	profile_dump();
+}
+
+void test_kernel(void)
+{
+	int tid = scheduler_thread_create(workload_thread, nullptr, 0);
+	scheduler_set_exit_hook(tid, workload_exited);
+	scheduler_kthread_create(report_thread, nullptr);
+	profile_start();
+	kprintf("profile_run started, dumping after the workload\n");
+}
@@ -0,0 +1,129 @@
+/*
+ * Common workload for comparing scheduling policies.
+ *
+ * Build with: make TSRC=tests/sched_bench.c qemu
+ * or for every policy in turn: tests/sched_bench.sh
+ *
+ * Busy threads, yielding threads and keystroke-like threads woken by an
+ * hrtimer run for one second. A 10 ms hrtimer acts as the tick for
+ * policies that preempt on it. The result is printed as one line of
+ * key=value pairs.
+ */
+#include <arch/bsp/systimer.h>
+#include <arch/cpu/irq_flags.h>
+#include <arch/cpu/scheduler.h>
+#include <kernel/hrtimer.h>
+#include <kernel/wait.h>
+#include <lib/kprintf.h>
+
+#define BUSY_THREADS  3
+#define YIELD_THREADS 2
+#define KEY_PERIOD_US 7000
+#define KEY_WORK_US   200
+#define TICK_US	      10000
+#define MEASURE_US    1000000
+
+static int	     busy_tids[BUSY_THREADS];
+static volatile bool stop = false;
+
+static wait_queue_t key_wait	= WAIT_QUEUE_INIT(key_wait);
+static uint32_t	    key_woken_at = 0;
+static uint32_t	    key_wakeups	 = 0;
+static uint32_t	    key_latency_max   = 0;
+static uint32_t	    key_latency_total = 0;
+
+static void key_func(struct hrtimer *timer)
+{
+	(void)timer;
+	key_woken_at = systimer_now();
+	wake_up(&key_wait);
+}
+
+static void tick_func(struct hrtimer *timer)
+{
+	(void)timer;
+	if (scheduler_policy_tick()) {
+		scheduler_need_resched();
+	}
+}
+
+static struct hrtimer key_timer	 = HRTIMER_INIT(key_func);
+static struct hrtimer tick_timer = HRTIMER_INIT(tick_func);
+
+static void busy_thread(void *arg)
+{
+	(void)arg;
+	while (!stop) {
+	}
+}
+
+static void yield_thread(void *arg)
+{
+	(void)arg;
+	while (!stop) {
+		scheduler_yield();
+	}
+}
+
+static void key_thread(void *arg)
+{
+	(void)arg;
+	while (!stop) {
+		uint32_t flags = local_irq_save();
+		wait_queue_sleep(&key_wait);
+		local_irq_restore(flags);
+
+		uint32_t latency = systimer_now() - key_woken_at;
+		key_wakeups++;
+		key_latency_total += latency;
+		if (latency > key_latency_max) {
+			key_latency_max = latency;
+		}
+
+		uint32_t start = systimer_now();
+		while (systimer_now() - start < KEY_WORK_US) {
+		}
+	}
+}
+
+static void report_thread(void *arg)
+{
+	(void)arg;
+
+	sched_rt_set(scheduler_get_current_thread(), 100, MEASURE_US, MEASURE_US);
+	scheduler_reset_stats();
+	hrtimer_start(&tick_timer, TICK_US, TICK_US);
+	hrtimer_start(&key_timer, KEY_PERIOD_US, KEY_PERIOD_US);
+	sched_rt_wait_period();
+
+	hrtimer_cancel(&tick_timer);
+	hrtimer_cancel(&key_timer);
+	stop = true;
+
+	uint32_t min = 0xFFFFFFFF;
+	uint32_t max = 0;
+	for (unsigned int i = 0; i < BUSY_THREADS; i++) {
+		// >> 10 instead of / 1000, there is no 64 bit division
+		uint32_t ms = (uint32_t)(scheduler_get_thread(busy_tids[i])->exec_total >> 10);
+		min	    = ms < min ? ms : min;
+		max	    = ms > max ? ms : max;
+	}
+
+	kprintf("\nsched_bench policy=%s busy_spread=%u key_wakeups=%u key_avg_us=%u "
+		"key_max_us=%u\n",
+		scheduler_policy_name(), max - min, key_wakeups,
+		key_wakeups ? key_latency_total / key_wakeups : 0, key_latency_max);
+	scheduler_print_stats();
+}
+
+void test_kernel(void)
+{
+	scheduler_kthread_create(report_thread, nullptr);
+	scheduler_kthread_create(key_thread, nullptr);
+	for (unsigned int i = 0; i < YIELD_THREADS; i++) {
+		scheduler_kthread_create(yield_thread, nullptr);
+	}
+	for (unsigned int i = 0; i < BUSY_THREADS; i++) {
+		busy_tids[i] = scheduler_kthread_create(busy_thread, nullptr);
+	}
+}
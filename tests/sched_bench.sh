@@ -0,0 +1,12 @@
+#!/bin/sh
+# Builds tests/sched_bench.c once per scheduling policy and collects the
+# result lines. QEMU does not exit on its own, every run is cut off
+# after RUN_SECONDS.
+RUN_SECONDS=${RUN_SECONDS:-30}
+
+for policy in SCHED_POLICY_RR SCHED_POLICY_FAIR SCHED_POLICY_MLFQ; do
+	make clean > /dev/null
+	timeout "$RUN_SECONDS" make TSRC=tests/sched_bench.c \
+		CFLAGS="-std=gnu23 -O2 -DSCHED_POLICY_SELECT=$policy" qemu 2>&1 |
+		grep -E '^(sched_bench|scheduler:)'
+done
@@ -0,0 +1,114 @@
+/*
+ * Runtime spread and pick cost of the normal scheduling policy.
+ *
+ * Build with: make TSRC=tests/sched_fairness.c qemu
+ *
+ * Busy threads compete with interactive threads that work briefly
+ * every few ms. A 1 ms hrtimer forces rescheduling independent of
+ * TIMER_INTERVAL. Run once per SCHED_POLICY (kconfig.h) and compare the
+ * spread of the busy threads and the runtime the interactive ones got.
+ */
+#include <arch/bsp/systimer.h>
+#include <arch/cpu/irq_flags.h>
+#include <arch/cpu/scheduler.h>
+#include <kernel/hrtimer.h>
+#include <kernel/kconfig.h>
+#include <kernel/wait.h>
+#include <lib/kprintf.h>
+
+#define BUSY_THREADS	    4
+#define INTERACTIVE_THREADS 2
+#define INTERACTIVE_WORK_US 300
+#define INTERACTIVE_GAP_US  5000
+#define MEASURE_US	    1000000
+
+static int	    busy_tids[BUSY_THREADS];
+static int	    interactive_tids[INTERACTIVE_THREADS];
+static volatile bool stop = false;
+
+static wait_queue_t input_queue = WAIT_QUEUE_INIT(input_queue);
+
+static void resched_func(struct hrtimer *timer)
+{
+	(void)timer;
+	scheduler_need_resched();
+}
+
+static void input_func(struct hrtimer *timer)
+{
+	(void)timer;
+	wake_up(&input_queue);
+}
+
+static struct hrtimer resched_timer = HRTIMER_INIT(resched_func);
+static struct hrtimer input_timer   = HRTIMER_INIT(input_func);
+
+static void busy_thread(void *arg)
+{
+	(void)arg;
+	while (!stop) {
+	}
+}
+
+static void interactive_thread(void *arg)
+{
+	(void)arg;
+	while (!stop) {
+		uint32_t flags = local_irq_save();
+		wait_queue_sleep(&input_queue);
+		local_irq_restore(flags);
+
+		uint32_t start = systimer_now();
+		while (systimer_now() - start < INTERACTIVE_WORK_US) {
+		}
+	}
+}
+
+static uint32_t runtime_ms(int tid)
+{
+	// >> 10 instead of / 1000, there is no 64 bit division
+	return (uint32_t)(scheduler_get_thread(tid)->exec_total >> 10);
+}
+
+static void report_thread(void *arg)
+{
+	(void)arg;
+
+	sched_rt_set(scheduler_get_current_thread(), 100, MEASURE_US, MEASURE_US);
+	scheduler_reset_stats();
+	hrtimer_start(&resched_timer, 1000, 1000);
+	hrtimer_start(&input_timer, INTERACTIVE_GAP_US, INTERACTIVE_GAP_US);
+	sched_rt_wait_period();
+
+	hrtimer_cancel(&resched_timer);
+	hrtimer_cancel(&input_timer);
+	stop = true;
+
+	kprintf("\npolicy %s, runtime in units of 1024 us\n",
+		SCHED_POLICY == SCHED_POLICY_FAIR ? "fair" : "round robin");
+
+	uint32_t min = 0xFFFFFFFF;
+	uint32_t max = 0;
+	for (unsigned int i = 0; i < BUSY_THREADS; i++) {
+		uint32_t ms = runtime_ms(busy_tids[i]);
+		min	    = ms < min ? ms : min;
+		max	    = ms > max ? ms : max;
+		kprintf("busy %u: %u\n", i, ms);
+	}
+	kprintf("busy spread: %u\n", max - min);
+	for (unsigned int i = 0; i < INTERACTIVE_THREADS; i++) {
+		kprintf("interactive %u: %u\n", i, runtime_ms(interactive_tids[i]));
+	}
+	scheduler_print_stats();
+}
+
+void test_kernel(void)
+{
+	scheduler_kthread_create(report_thread, nullptr);
+	for (unsigned int i = 0; i < INTERACTIVE_THREADS; i++) {
+		interactive_tids[i] = scheduler_kthread_create(interactive_thread, nullptr);
+	}
+	for (unsigned int i = 0; i < BUSY_THREADS; i++) {
+		busy_tids[i] = scheduler_kthread_create(busy_thread, nullptr);
+	}
+}
@@ -0,0 +1,58 @@
+/*
+ * Cost of a printed line through the buffered stdio against one syscall
+ * per character and against uart_putc called straight from user mode.
+ *
+ * Build with: make TSRC=tests/stdio_bench.c qemu
+ */
+#include <arch/bsp/uart.h>
+#include <arch/cpu/pmu.h>
+#include <arch/cpu/scheduler.h>
+#include <user/stdio.h>
+#include <user/syscall.h>
+
+#define LINES 40
+
+static const char line[] = "the quick brown fox jumps over the dog\n";
+
+static void bench_thread(void *arg)
+{
+	(void)arg;
+	struct stdio_stats before;
+	struct stdio_stats after;
+	uint32_t	   chars = sizeof(line) - 1;
+
+	stdio_get_stats(&before);
+	uint32_t start = pmu_cycles();
+	for (unsigned int i = 0; i < LINES; i++) {
+		printf("%2u %s", i, line);
+	}
+	uint32_t buffered = pmu_cycles() - start;
+	stdio_get_stats(&after);
+
+	start = pmu_cycles();
+	for (unsigned int i = 0; i < LINES; i++) {
+		for (uint32_t c = 0; c < chars; c++) {
+			sys_write(&line[c], 1);
+		}
+	}
+	uint32_t per_char = pmu_cycles() - start;
+
+	start = pmu_cycles();
+	for (unsigned int i = 0; i < LINES; i++) {
+		for (uint32_t c = 0; c < chars; c++) {
+			uart_putc(line[c]);
+		}
+	}
+	uint32_t direct = pmu_cycles() - start;
+
+	printf("stdio_bench buffered_cycles_per_line=%u buffered_syscalls_per_line=%u\n",
+	       buffered / LINES, (after.writes - before.writes) / LINES);
+	printf("stdio_bench per_char_cycles_per_line=%u per_char_syscalls_per_line=%u\n",
+	       per_char / LINES, chars);
+	printf("stdio_bench direct_cycles_per_line=%u\n", direct / LINES);
+}
+
+void test_kernel(void)
+{
+	scheduler_thread_create(bench_thread, nullptr, 0);
+}
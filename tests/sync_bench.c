@@ -0,0 +1,208 @@
+/*
+ * Cost of mutexes, semaphores and condition variables, and a priority
+ * inheritance check.
+ *
+ * Build with: make TSRC=tests/sync_bench.c qemu
+ *
+ * All threads are user threads. The main bench thread runs the phases
+ * one after another and releases the helper threads of each phase
+ * through semaphores:
+ *   1. uncontended lock/unlock against a plain syscall round trip
+ *   2. contended: every holder yields inside the critical section
+ *   3. semaphore and condition variable ping-pong between two threads
+ *   4. priority inheritance: an RT thread waits for a mutex held by a
+ *      normal thread while busy normal threads compete for the CPU
+ */
+#include <arch/bsp/systimer.h>
+#include <arch/cpu/scheduler.h>
+#include <kernel/futex.h>
+#include <lib/kprintf.h>
+#include <user/sync.h>
+#include <user/syscall.h>
+
+#define UNCONTENDED_ROUNDS 10000
+#define CONTENDED_THREADS  3
+#define CONTENDED_ROUNDS   200
+#define PING_PONG_ROUNDS   500
+#define PI_HOLD_US	   3000
+#define PI_BUSY_THREADS	   2
+
+static mutex_t lock	    = MUTEX_INIT;
+static uint32_t shared_counter = 0;
+
+static sem_t contended_start = SEM_INIT(0);
+static sem_t contended_done  = SEM_INIT(0);
+static sem_t ping_start	     = SEM_INIT(0);
+static sem_t ping	     = SEM_INIT(0);
+static sem_t pong	     = SEM_INIT(0);
+static sem_t pi_start	     = SEM_INIT(0);
+
+static mutex_t cond_lock = MUTEX_INIT;
+static cond_t  cond	 = COND_INIT;
+static uint32_t cond_turn = 0;
+
+static mutex_t	      pi_lock	  = MUTEX_INIT;
+static volatile bool pi_locked	  = false;
+static volatile bool pi_done	  = false;
+
+/* ns per round from µs for all rounds */
+static uint32_t ns_per_round(uint32_t us, uint32_t rounds)
+{
+	return us * 1000 / rounds;
+}
+
+static void contended_thread(void *arg)
+{
+	(void)arg;
+	sem_wait(&contended_start);
+
+	for (unsigned int i = 0; i < CONTENDED_ROUNDS; i++) {
+		mutex_lock(&lock);
+		shared_counter++;
+		sys_yield();
+		mutex_unlock(&lock);
+	}
+
+	sem_post(&contended_done);
+}
+
+static void ping_pong_thread(void *arg)
+{
+	(void)arg;
+	sem_wait(&ping_start);
+
+	for (unsigned int i = 0; i < PING_PONG_ROUNDS; i++) {
+		sem_wait(&ping);
+		sem_post(&pong);
+	}
+
+	mutex_lock(&cond_lock);
+	for (unsigned int i = 0; i < PING_PONG_ROUNDS; i++) {
+		while (cond_turn != 1) {
+			cond_wait(&cond, &cond_lock);
+		}
+		cond_turn = 0;
+		cond_signal(&cond);
+	}
+	mutex_unlock(&cond_lock);
+}
+
+static void pi_low_thread(void *arg)
+{
+	(void)arg;
+	sem_wait(&pi_start);
+
+	mutex_lock(&pi_lock);
+	pi_locked = true;
+	// Let the RT thread run into the mutex
+	sys_yield();
+	uint32_t start = systimer_now();
+	while (systimer_now() - start < PI_HOLD_US) {
+	}
+	mutex_unlock(&pi_lock);
+}
+
+static void pi_high_thread(void *arg)
+{
+	(void)arg;
+	sem_wait(&pi_start);
+
+	while (!pi_locked) {
+		sys_yield();
+	}
+	sys_rt_set(1000, 100000, 100000);
+
+	uint32_t start = systimer_now();
+	mutex_lock(&pi_lock);
+	uint32_t waited = systimer_now() - start;
+	mutex_unlock(&pi_lock);
+
+	kprintf("\nsync_bench pi_wait_us=%u (hold time %u us)\n", waited, PI_HOLD_US);
+	pi_done = true;
+}
+
+/* Without priority inheritance these keep the mutex owner off the CPU */
+static void pi_busy_thread(void *arg)
+{
+	(void)arg;
+	sem_wait(&pi_start);
+
+	while (!pi_done) {
+	}
+}
+
+static void bench_thread(void *arg)
+{
+	(void)arg;
+
+	uint32_t start = systimer_now();
+	for (unsigned int i = 0; i < UNCONTENDED_ROUNDS; i++) {
+		mutex_lock(&lock);
+		mutex_unlock(&lock);
+	}
+	uint32_t lock_us = systimer_now() - start;
+
+	start = systimer_now();
+	for (unsigned int i = 0; i < UNCONTENDED_ROUNDS; i++) {
+		sys_futex_wake(&lock.word, 1);
+	}
+	uint32_t syscall_us = systimer_now() - start;
+
+	kprintf("\nsync_bench uncontended_lock_ns=%u syscall_ns=%u\n",
+		ns_per_round(lock_us, UNCONTENDED_ROUNDS), ns_per_round(syscall_us, UNCONTENDED_ROUNDS));
+
+	start = systimer_now();
+	for (unsigned int i = 0; i < CONTENDED_THREADS; i++) {
+		sem_post(&contended_start);
+	}
+	for (unsigned int i = 0; i < CONTENDED_THREADS; i++) {
+		sem_wait(&contended_done);
+	}
+	uint32_t contended_us = systimer_now() - start;
+
+	kprintf("sync_bench contended_lock_ns=%u counter=%u expected=%u\n",
+		ns_per_round(contended_us, CONTENDED_THREADS * CONTENDED_ROUNDS), shared_counter,
+		CONTENDED_THREADS * CONTENDED_ROUNDS);
+
+	sem_post(&ping_start);
+	start = systimer_now();
+	for (unsigned int i = 0; i < PING_PONG_ROUNDS; i++) {
+		sem_post(&ping);
+		sem_wait(&pong);
+	}
+	uint32_t sem_us = systimer_now() - start;
+
+	start = systimer_now();
+	mutex_lock(&cond_lock);
+	for (unsigned int i = 0; i < PING_PONG_ROUNDS; i++) {
+		cond_turn = 1;
+		cond_signal(&cond);
+		while (cond_turn != 0) {
+			cond_wait(&cond, &cond_lock);
+		}
+	}
+	mutex_unlock(&cond_lock);
+	uint32_t cond_us = systimer_now() - start;
+
+	kprintf("sync_bench sem_round_trip_ns=%u cond_round_trip_ns=%u\n",
+		ns_per_round(sem_us, PING_PONG_ROUNDS), ns_per_round(cond_us, PING_PONG_ROUNDS));
+	futex_print_stats();
+
+	for (unsigned int i = 0; i < 2 + PI_BUSY_THREADS; i++) {
+		sem_post(&pi_start);
+	}
+}
+
+void test_kernel(void)
+{
+	scheduler_thread_create(bench_thread, nullptr, 0);
+	for (unsigned int i = 0; i < CONTENDED_THREADS; i++) {
+		scheduler_thread_create(contended_thread, nullptr, 0);
+	}
+	scheduler_thread_create(ping_pong_thread, nullptr, 0);
+	scheduler_thread_create(pi_low_thread, nullptr, 0);
+	scheduler_thread_create(pi_high_thread, nullptr, 0);
+	for (unsigned int i = 0; i < PI_BUSY_THREADS; i++) {
+		scheduler_thread_create(pi_busy_thread, nullptr, 0);
+	}
+}
@@ -0,0 +1,90 @@
+/*
+ * Cost of a timestamp from the time page against the time syscall, and
+ * how far the extrapolated time is off the systimer.
+ *
+ * Build with: make TSRC=tests/time_bench.c qemu
+ *
+ * The accuracy run spreads its samples over several page updates, so
+ * both fresh and nearly stale snapshots are measured. The monotonic
+ * run reads back to back across updates and counts every step back.
+ */
+#include <arch/bsp/systimer.h>
+#include <arch/cpu/scheduler.h>
+#include <kernel/kconfig.h>
+#include <lib/kprintf.h>
+#include <user/syscall.h>
+#include <user/time.h>
+
+#define ROUNDS	1000
+#define SAMPLES 200
+
+static void bench_thread(void *arg)
+{
+	(void)arg;
+	volatile uint64_t sink;
+
+	time_now_us(); // fetches the page address once
+	uint32_t start = time_cycles();
+	for (unsigned int i = 0; i < ROUNDS; i++) {
+		sink = time_now_us();
+	}
+	uint32_t page_cycles = time_cycles() - start;
+
+	start = time_cycles();
+	for (unsigned int i = 0; i < ROUNDS; i++) {
+		sink = sys_time_us();
+	}
+	uint32_t syscall_cycles = time_cycles() - start;
+	(void)sink;
+
+	kprintf("\ntime_bench page_cycles=%u syscall_cycles=%u\n", page_cycles / ROUNDS,
+		syscall_cycles / ROUNDS);
+
+	uint32_t error_max = 0;
+	bool	 monotonic = true;
+	uint64_t last	   = 0;
+	for (unsigned int i = 0; i < SAMPLES; i++) {
+		uint32_t before = systimer_now();
+		uint64_t now	= time_now_us();
+		uint32_t after	= systimer_now();
+
+		// Only the low 32 bit are comparable with the systimer
+		uint32_t low   = (uint32_t)now;
+		uint32_t error = 0;
+		if ((int32_t)(low - before) < 0) {
+			error = before - low;
+		} else if ((int32_t)(low - after) > 0) {
+			error = low - after;
+		}
+		if (error > error_max) {
+			error_max = error;
+		}
+		monotonic = monotonic && now >= last;
+		last	  = now;
+
+		// Busy until the next sample, a few of them per page update
+		uint32_t until = systimer_now() + TIME_PAGE_PERIOD_US / 4;
+		while ((int32_t)(systimer_now() - until) < 0) {
+		}
+	}
+
+	kprintf("time_bench error_max_us=%u monotonic=%s jiffies=%u\n", error_max,
+		monotonic ? "yes" : "NO", time_jiffies());
+
+	uint32_t reads	   = 0;
+	uint32_t backwards = 0;
+	uint32_t until	   = systimer_now() + 5 * TIME_PAGE_PERIOD_US;
+	last		   = time_now_us();
+	while ((int32_t)(systimer_now() - until) < 0) {
+		uint64_t now = time_now_us();
+		backwards += now < last;
+		last = now;
+		reads++;
+	}
+	kprintf("time_bench back_to_back_reads=%u backwards=%u\n", reads, backwards);
+}
+
+void test_kernel(void)
+{
+	scheduler_thread_create(bench_thread, nullptr, 0);
+}
@@ -0,0 +1,63 @@
+/*
+ * Cost of reading the time and tick IRQ latency, systimer against the
+ * generic timer.
+ *
+ * Build with: make TSRC=tests/timer_cost.c qemu
+ *
+ * The latency part measures the configured tick source, run it once
+ * with TICK_GENERIC_TIMER (kconfig.h) set and once without.
+ */
+#include <config.h>
+#include <arch/bsp/systimer.h>
+#include <arch/cpu/generic_timer.h>
+#include <arch/cpu/pmu.h>
+#include <arch/cpu/scheduler.h>
+#include <kernel/kconfig.h>
+#include <lib/kprintf.h>
+
+#define READ_COUNT    1024
+#define MEASURE_TICKS 3
+
+static volatile uint32_t sink;
+
+static uint32_t systimer_read_cycles(void)
+{
+	uint32_t start = pmu_cycles();
+	for (unsigned int i = 0; i < READ_COUNT; i++) {
+		sink = systimer_now();
+	}
+	return (pmu_cycles() - start) / READ_COUNT;
+}
+
+static uint32_t generic_timer_read_cycles(void)
+{
+	uint32_t start = pmu_cycles();
+	for (unsigned int i = 0; i < READ_COUNT; i++) {
+		sink = (uint32_t)generic_timer_count();
+	}
+	return (pmu_cycles() - start) / READ_COUNT;
+}
+
+static void timer_cost_thread(void *arg)
+{
+	(void)arg;
+
+	kprintf("\nread cost: systimer CLO %u cycles, CNTVCT %u cycles (%u Hz)\n",
+		systimer_read_cycles(), generic_timer_read_cycles(), generic_timer_freq());
+
+	systimer_irq_latency_reset();
+	generic_timer_irq_latency_reset();
+	scheduler_sleep(MEASURE_TICKS);
+
+	if (TICK_GENERIC_TIMER) {
+		kprintf("tick latency max: generic timer %u us\n",
+			generic_timer_irq_latency_max());
+	} else {
+		kprintf("tick latency max: systimer %u us\n", systimer_irq_latency_max());
+	}
+}
+
+void test_kernel(void)
+{
+	scheduler_kthread_create(timer_cost_thread, nullptr);
+}
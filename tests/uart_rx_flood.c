@@ -0,0 +1,99 @@
+/*
+ * UART RX under a flood of input, with the PL011 in loopback.
+ *
+ * Build with: tests/uart_rx_flood.sh (both UART_RX_FIQ settings) or
+ * make TSRC=tests/uart_rx_flood.c qemu
+ *
+ * Every burst is written with IRQs masked, so the IRQ path can only
+ * drain the 16 byte RX FIFO once the burst is over while the FIQ path
+ * keeps draining it underneath. A kernel thread reads everything back
+ * with uart_getc() between bursts. The counters are the deltas of
+ * uart_get_rx_stats() over each burst size:
+ *  - overruns: the FIFO was full, characters were lost in the PL011
+ *  - input_drops: the raw input buffer was full when the FIFO was drained
+ *  - buffer_overflows: the getc buffer was full, the reader fell behind
+ */
+#include <arch/bsp/systimer.h>
+#include <arch/bsp/uart.h>
+#include <arch/cpu/irq_flags.h>
+#include <arch/cpu/scheduler.h>
+#include <kernel/kconfig.h>
+#include <lib/kprintf.h>
+#include <user/syscall.h>
+
+#define ROUNDS 20
+#define GAP_US 20000
+
+static const uint32_t burst_sizes[] = { 8, 16, 64, 256 };
+
+static volatile uint32_t received = 0;
+
+static void reader_thread(void *arg)
+{
+	(void)arg;
+	while (true) {
+		if (uart_getc() == '.') {
+			received++;
+		}
+	}
+}
+
+static void gap(void)
+{
+	uint32_t start = systimer_now();
+	while (systimer_now() - start < GAP_US) {
+		scheduler_yield();
+	}
+}
+
+static void flood(uint32_t burst)
+{
+	struct uart_rx_stats before, after;
+	uart_get_rx_stats(&before);
+	uint32_t received_before = received;
+
+	// Only the flood characters go round, not the result lines
+	uart_loopback(true);
+	for (unsigned int round = 0; round < ROUNDS; round++) {
+		uint32_t flags = local_irq_save();
+		for (uint32_t i = 0; i < burst; i++) {
+			uart_putc('.');
+		}
+		local_irq_restore(flags);
+		gap();
+	}
+	uart_loopback(false);
+
+	uart_get_rx_stats(&after);
+	kprintf("uart_rx_flood path=%s burst=%u sent=%u received=%u overruns=%u "
+		"input_drops=%u buffer_overflows=%u\n",
+		UART_RX_FIQ ? "fiq" : "irq", burst, burst * ROUNDS, received - received_before,
+		after.overruns - before.overruns, after.input_drops - before.input_drops,
+		after.rx_overflows - before.rx_overflows);
+}
+
+static void flood_thread(void *arg)
+{
+	(void)arg;
+
+	kprintf("\n");
+	for (unsigned int i = 0; i < sizeof(burst_sizes) / sizeof(burst_sizes[0]); i++) {
+		flood(burst_sizes[i]);
+	}
+	kprintf("uart_rx_flood done\n");
+}
+
+/* Parks the input threads, main() would print every flood character */
+void test_user(void *args)
+{
+	(void)args;
+	while (true) {
+		sys_sleep(1000000);
+	}
+}
+
+void test_kernel(void)
+{
+	scheduler_kthread_create(reader_thread, nullptr);
+	scheduler_kthread_create(flood_thread, nullptr);
+}
@@ -0,0 +1,12 @@
+#!/bin/sh
+# Builds tests/uart_rx_flood.c once with RX on the UART IRQ and once on
+# the FIQ and collects the result lines. QEMU does not exit on its own,
+# every run is cut off after RUN_SECONDS.
+RUN_SECONDS=${RUN_SECONDS:-30}
+
+for fiq in false true; do
+	make clean > /dev/null
+	timeout "$RUN_SECONDS" make TSRC=tests/uart_rx_flood.c \
+		CFLAGS="-std=gnu23 -DUART_RX_FIQ_SELECT=$fiq" qemu 2>&1 |
+		grep -a '^uart_rx_flood'
+done
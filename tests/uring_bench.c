@@ -0,0 +1,92 @@
+/*
+ * Operations per second through the submission ring against one
+ * syscall per operation.
+ *
+ * Build with: make TSRC=tests/uring_bench.c qemu
+ *
+ * The operation is a futex wake on a word nobody waits on, so the cost
+ * is almost only the way into the kernel and back. The SQPOLL run waits
+ * for each batch as well; on the single core the poller only runs while
+ * the submitter waits or yields, so it shows the polling overhead more
+ * than the saved traps. The uring stats after each run count the enter
+ * syscalls.
+ */
+#include <arch/bsp/systimer.h>
+#include <arch/cpu/scheduler.h>
+#include <kernel/uring.h>
+#include <lib/kprintf.h>
+#include <user/syscall.h>
+#include <user/uring.h>
+
+#define OPS   3200
+#define BATCH 16
+
+static struct uring	 ring;
+static struct uring	 poll_ring;
+static volatile uint32_t futex_word = 0;
+
+static uint32_t ops_per_s(uint32_t us)
+{
+	uint32_t ms = us / 1000;
+	return ms ? OPS * 1000 / ms : 0;
+}
+
+/* Returns false if a completion is missing or failed */
+static bool run_batches(struct uring *r)
+{
+	bool ok = true;
+
+	for (unsigned int b = 0; b < OPS / BATCH; b++) {
+		for (unsigned int i = 0; i < BATCH; i++) {
+			struct uring_sqe *sqe = uring_get_sqe(r);
+			sqe->op		      = URING_OP_FUTEX_WAKE;
+			sqe->arg0	      = (uint32_t)&futex_word;
+			sqe->arg1	      = 1;
+			sqe->user_data	      = b * BATCH + i;
+		}
+		uring_submit_and_wait(r, BATCH);
+
+		for (unsigned int i = 0; i < BATCH; i++) {
+			struct uring_cqe *cqe = uring_peek_cqe(r);
+			ok = ok && cqe && cqe->result == 0 && cqe->user_data == b * BATCH + i;
+			if (cqe) {
+				uring_cqe_seen(r);
+			}
+		}
+	}
+	return ok;
+}
+
+static void bench_thread(void *arg)
+{
+	(void)arg;
+
+	uint32_t start = systimer_now();
+	for (unsigned int i = 0; i < OPS; i++) {
+		sys_futex_wake(&futex_word, 1);
+	}
+	uint32_t syscall_us = systimer_now() - start;
+
+	uring_setup(&ring, 0);
+	start		    = systimer_now();
+	bool	 batched_ok = run_batches(&ring);
+	uint32_t batched_us = systimer_now() - start;
+
+	kprintf("\nuring_bench syscall_ops_per_s=%u batched_ops_per_s=%u batch=%u ok=%s\n",
+		ops_per_s(syscall_us), ops_per_s(batched_us), BATCH, batched_ok ? "yes" : "NO");
+	uring_print_stats();
+
+	uring_setup(&poll_ring, URING_SETUP_SQPOLL);
+	start		   = systimer_now();
+	bool	 sqpoll_ok = run_batches(&poll_ring);
+	uint32_t poll_us   = systimer_now() - start;
+
+	kprintf("uring_bench sqpoll_ops_per_s=%u ok=%s\n", ops_per_s(poll_us),
+		sqpoll_ok ? "yes" : "NO");
+	uring_print_stats();
+}
+
+void test_kernel(void)
+{
+	scheduler_thread_create(bench_thread, nullptr, 0);
+}
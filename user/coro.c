@@ -0,0 +1,122 @@
+#include <user/coro.h>
+#include <user/syscall.h>
+#include <lib/atomic.h>
+#include <lib/mem.h>
+
+void coro_start(void);
+void coro_entry [[noreturn]] (struct coro *coro);
+
+void coro_sched_init(struct coro_sched *sched)
+{
+	memset(sched, 0, sizeof(*sched));
+	list_init(&sched->ready);
+}
+
+void coro_create(struct coro_sched *sched, struct coro *coro, void *stack, uint32_t stack_size,
+		 void (*func)(struct coro_sched *sched, void *arg), void *arg)
+{
+	memset(&coro->context, 0, sizeof(coro->context));
+	coro->context.r4 = (uint32_t)coro;
+	coro->context.sp = ((uint32_t)stack + stack_size) & ~0x7;
+	coro->context.lr = (uint32_t)coro_start;
+
+	coro->sched = sched;
+	coro->func  = func;
+	coro->arg   = arg;
+	coro->done  = false;
+
+	sched->live++;
+	list_add_last(&sched->ready, &coro->node);
+}
+
+/* Context of the next coroutine to run, the host's once none is left */
+static struct coro_context *next_context(struct coro_sched *sched)
+{
+	list_node *node = list_remove_first(&sched->ready);
+
+	if (!node) {
+		sched->current = nullptr;
+		return &sched->host;
+	}
+
+	sched->current = list_entry(node, struct coro, node);
+	sched->switches++;
+	return &sched->current->context;
+}
+
+void coro_entry [[noreturn]] (struct coro *coro)
+{
+	struct coro_sched *sched = coro->sched;
+
+	coro->func(sched, coro->arg);
+
+	coro->done = true;
+	sched->live--;
+	// Nothing ever switches back to this context
+	struct coro_context dead;
+	coro_switch(&dead, next_context(sched));
+	__builtin_unreachable();
+}
+
+void coro_run(struct coro_sched *sched)
+{
+	while (!list_is_empty(&sched->ready)) {
+		coro_switch(&sched->host, next_context(sched));
+	}
+}
+
+void coro_yield(struct coro_sched *sched)
+{
+	struct coro *current = sched->current;
+
+	if (list_is_empty(&sched->ready)) {
+		return;
+	}
+
+	list_add_last(&sched->ready, &current->node);
+	coro_switch(&current->context, next_context(sched));
+}
+
+/*
+ * The ready queue is FIFO, so once live polls in a row failed every
+ * waiting coroutine has polled since round_seq was taken. A coro_wake
+ * after that changed wake_seq and the futex wait returns at once.
+ */
+void coro_block(struct coro_sched *sched, bool (*ready)(void *arg), void *arg)
+{
+	sched->waiting++;
+	while (!ready(arg)) {
+		if (sched->waiting == sched->live && sched->idle_polls >= sched->live) {
+			sched->kernel_blocks++;
+			sys_futex_wait(&sched->wake_seq, sched->round_seq);
+			sched->round_seq  = sched->wake_seq;
+			sched->idle_polls = 0;
+		} else {
+			sched->idle_polls++;
+			coro_yield(sched);
+		}
+	}
+	sched->waiting--;
+}
+
+void coro_wake(struct coro_sched *sched)
+{
+	atomic_add_return(&sched->wake_seq, 1);
+	sys_futex_wake(&sched->wake_seq, 1);
+}
+
+static bool sem_ready(void *sem)
+{
+	return sem_trywait(sem);
+}
+
+void coro_sem_wait(struct coro_sched *sched, sem_t *sem)
+{
+	coro_block(sched, sem_ready, sem);
+}
+
+void coro_sem_post(struct coro_sched *sched, sem_t *sem)
+{
+	sem_post(sem);
+	coro_wake(sched);
+}
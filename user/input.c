@@ -0,0 +1,12 @@
+#include <user/input.h>
+#include <user/main.h>
+#include <user/syscall.h>
+
+void input_worker(void *arg)
+{
+	(void)arg;
+	while (true) {
+		char c = sys_input_wait();
+		main(&c);
+	}
+}
@@ -0,0 +1,57 @@
+#include <user/ipc.h>
+#include <user/syscall.h>
+
+/*
+ * Traps with the message in r1-r6 and stores the r1-r6 the kernel
+ * returns back into msg. r7 carries the sender filter of reply_receive.
+ */
+#define ipc_svc(nr, arg, from, msg)                                                   \
+	({                                                                            \
+		register uint32_t r0 asm("r0") = (arg);                               \
+		register uint32_t r1 asm("r1") = (msg)->w[0];                         \
+		register uint32_t r2 asm("r2") = (msg)->w[1];                         \
+		register uint32_t r3 asm("r3") = (msg)->w[2];                         \
+		register uint32_t r4 asm("r4") = (msg)->w[3];                         \
+		register uint32_t r5 asm("r5") = (msg)->w[4];                         \
+		register uint32_t r6 asm("r6") = (msg)->w[5];                         \
+		register uint32_t r7 asm("r7") = (from);                              \
+		asm volatile("svc %8"                                                 \
+			     : "+r"(r0), "+r"(r1), "+r"(r2), "+r"(r3), "+r"(r4),      \
+			       "+r"(r5), "+r"(r6), "+r"(r7)                           \
+			     : "i"(nr)                                                \
+			     : "memory");                                             \
+		(msg)->w[0] = r1;                                                     \
+		(msg)->w[1] = r2;                                                     \
+		(msg)->w[2] = r3;                                                     \
+		(msg)->w[3] = r4;                                                     \
+		(msg)->w[4] = r5;                                                     \
+		(msg)->w[5] = r6;                                                     \
+		(int)r0;                                                              \
+	})
+
+int ipc_send(uint32_t dest, const struct ipc_msg *msg)
+{
+	struct ipc_msg copy = *msg;
+	return ipc_svc(SYSCALL_IPC_SEND, dest, 0, &copy);
+}
+
+int ipc_receive(uint32_t from, struct ipc_msg *msg)
+{
+	return ipc_svc(SYSCALL_IPC_RECV, from, 0, msg);
+}
+
+int ipc_call(uint32_t dest, struct ipc_msg *msg)
+{
+	return ipc_svc(SYSCALL_IPC_CALL, dest, 0, msg);
+}
+
+int ipc_reply(uint32_t client, const struct ipc_msg *msg)
+{
+	struct ipc_msg copy = *msg;
+	return ipc_svc(SYSCALL_IPC_REPLY, client, 0, &copy);
+}
+
+int ipc_reply_receive(uint32_t client, struct ipc_msg *msg, uint32_t from)
+{
+	return ipc_svc(SYSCALL_IPC_REPLY_RECV, client, from, msg);
+}
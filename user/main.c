@@ -1,7 +1,7 @@
 #include <config.h>
-#include <arch/bsp/uart.h>
 #include <tests/regcheck.h>
 #include <user/main.h>
+#include <user/stdio.h>
 
 void do_data_abort(void)
 {
@@ -51,6 +51,8 @@ void main(void *args)
 	for (unsigned int n = 0; n < PRINT_COUNT; n++) {
 		for (volatile unsigned int i = 0; i < BUSY_WAIT_COUNTER; i++) {
 		}
-		uart_putc(c);
+		// Flushed right away, each character shows up as soon as it is due
+		putchar(c);
+		fflush();
 	}
 }
@@ -0,0 +1,287 @@
+#include <user/malloc.h>
+#include <user/sync.h>
+#include <user/syscall.h>
+#include <kernel/pages.h>
+
+#define CLASSES	    7 // 16 << class bytes
+#define MIN_SHIFT   4
+#define CACHE_MAX   32 // objects per class and thread before half is flushed
+#define REFILL	    8
+#define HEADER_SIZE 16
+#define PAGE_MAGIC  0x4D41u
+#define LARGE	    0xFFu
+
+/* At the start of every page of small objects and of every large run */
+struct page_header {
+	uint16_t	    magic;
+	uint8_t		    class;
+	uint8_t		    reserved;
+	uint32_t	    pages;
+	struct page_header *next; // free large runs only, in address order
+	uint32_t	    padding;
+};
+
+static_assert(sizeof(struct page_header) == HEADER_SIZE);
+
+struct object {
+	struct object *next;
+};
+
+struct cache {
+	struct object *free[CLASSES];
+	uint32_t       count[CLASSES];
+	int32_t	       in_use; // may go negative, frees of other threads' objects count here
+};
+
+static struct cache	   caches[MALLOC_THREADS];
+static mutex_t		   central_lock = MUTEX_INIT;
+static struct object	  *central[CLASSES];
+static uint32_t		   central_bytes = 0;
+static struct page_header *large_free    = nullptr;
+static uint32_t		   heap_pages	 = 0;
+static uint8_t		  *heap_end	 = nullptr; // break, malloc is the only sbrk user
+
+static uint32_t class_size(unsigned int class)
+{
+	return 1u << (class + MIN_SHIFT);
+}
+
+static unsigned int class_of(size_t size)
+{
+	unsigned int class = 0;
+	while (class_size(class) < size) {
+		class++;
+	}
+	return class;
+}
+
+static struct cache *own_cache(void)
+{
+	return &caches[sync_thread_id() % MALLOC_THREADS];
+}
+
+static struct page_header *header_of(void *ptr)
+{
+	return (struct page_header *)((uint32_t)ptr & ~(PAGE_SIZE - 1));
+}
+
+static void *more_pages(uint32_t pages)
+{
+	uint8_t *base = sys_sbrk((int32_t)pages);
+	if (base) {
+		heap_pages += pages;
+		heap_end = base + pages * PAGE_SIZE;
+	}
+	return base;
+}
+
+static uint8_t *run_end(struct page_header *run)
+{
+	return (uint8_t *)run + run->pages * PAGE_SIZE;
+}
+
+/*
+ * Puts a freed run back in address order, merges it with free
+ * neighbours and hands a free run at the top back to the kernel, lock
+ * held.
+ */
+static void put_run(struct page_header *run)
+{
+	// Stops at the first run that ends at or behind the start of run
+	struct page_header **link = &large_free;
+	while (*link && run_end(*link) < (uint8_t *)run) {
+		link = &(*link)->next;
+	}
+
+	if (*link && run_end(*link) == (uint8_t *)run) {
+		(*link)->pages += run->pages;
+		run = *link;
+	} else {
+		run->next = *link;
+		*link	  = run;
+	}
+
+	struct page_header *next = run->next;
+	if (next && run_end(run) == (uint8_t *)next) {
+		run->pages += next->pages;
+		run->next = next->next;
+	}
+
+	// Only the last run can end at the break
+	if (!run->next && run_end(run) == heap_end && sys_sbrk(-(int32_t)run->pages)) {
+		heap_pages -= run->pages;
+		heap_end = (uint8_t *)run;
+		*link	 = nullptr;
+	}
+}
+
+/* Cuts a new page into objects of class onto the central list, lock held */
+static bool grow_class(unsigned int class)
+{
+	struct page_header *page = more_pages(1);
+	if (!page) {
+		return false;
+	}
+
+	page->magic = PAGE_MAGIC;
+	page->class = class;
+	page->pages = 1;
+
+	uint32_t size = class_size(class);
+	uint8_t *obj  = (uint8_t *)page + (size > HEADER_SIZE ? size : HEADER_SIZE);
+	for (; obj + size <= (uint8_t *)page + PAGE_SIZE; obj += size) {
+		struct object *o = (struct object *)obj;
+		o->next		 = central[class];
+		central[class]	 = o;
+		central_bytes += size;
+	}
+	return true;
+}
+
+static void refill(struct cache *cache, unsigned int class)
+{
+	mutex_lock(&central_lock);
+	if (!central[class]) {
+		grow_class(class);
+	}
+	for (unsigned int i = 0; i < REFILL && central[class]; i++) {
+		struct object *o   = central[class];
+		central[class]	   = o->next;
+		o->next		   = cache->free[class];
+		cache->free[class] = o;
+		cache->count[class]++;
+		central_bytes -= class_size(class);
+	}
+	mutex_unlock(&central_lock);
+}
+
+static void flush(struct cache *cache, unsigned int class)
+{
+	mutex_lock(&central_lock);
+	while (cache->count[class] > CACHE_MAX / 2) {
+		struct object *o   = cache->free[class];
+		cache->free[class] = o->next;
+		o->next		   = central[class];
+		central[class]	   = o;
+		cache->count[class]--;
+		central_bytes += class_size(class);
+	}
+	mutex_unlock(&central_lock);
+}
+
+/* First fit over the freed runs, splitting off the rest, lock held */
+static struct page_header *take_run(uint32_t pages)
+{
+	for (struct page_header **link = &large_free; *link; link = &(*link)->next) {
+		struct page_header *run = *link;
+		if (run->pages < pages) {
+			continue;
+		}
+
+		if (run->pages > pages) {
+			struct page_header *rest =
+				(struct page_header *)((uint8_t *)run + pages * PAGE_SIZE);
+			rest->magic = PAGE_MAGIC;
+			rest->class = LARGE;
+			rest->pages = run->pages - pages;
+			rest->next  = run->next;
+			*link	    = rest;
+		} else {
+			*link = run->next;
+		}
+		return run;
+	}
+
+	return more_pages(pages);
+}
+
+static void *malloc_large(size_t size)
+{
+	uint32_t pages = (size + HEADER_SIZE + PAGE_SIZE - 1) / PAGE_SIZE;
+
+	mutex_lock(&central_lock);
+	struct page_header *run = take_run(pages);
+	mutex_unlock(&central_lock);
+	if (!run) {
+		return nullptr;
+	}
+
+	run->magic = PAGE_MAGIC;
+	run->class = LARGE;
+	run->pages = pages;
+	own_cache()->in_use += (int32_t)(pages * PAGE_SIZE);
+	return (uint8_t *)run + HEADER_SIZE;
+}
+
+void *malloc(size_t size)
+{
+	if (size == 0) {
+		size = 1;
+	}
+	if (size > class_size(CLASSES - 1)) {
+		return malloc_large(size);
+	}
+
+	unsigned int  class = class_of(size);
+	struct cache *cache = own_cache();
+
+	if (!cache->free[class]) {
+		refill(cache, class);
+		if (!cache->free[class]) {
+			return nullptr;
+		}
+	}
+
+	struct object *o   = cache->free[class];
+	cache->free[class] = o->next;
+	cache->count[class]--;
+	cache->in_use += (int32_t)class_size(class);
+	return o;
+}
+
+void free(void *ptr)
+{
+	if (!ptr) {
+		return;
+	}
+
+	struct page_header *page  = header_of(ptr);
+	struct cache	   *cache = own_cache();
+
+	if (page->class == LARGE) {
+		cache->in_use -= (int32_t)(page->pages * PAGE_SIZE);
+		mutex_lock(&central_lock);
+		put_run(page);
+		mutex_unlock(&central_lock);
+		return;
+	}
+
+	unsigned int   class = page->class;
+	struct object *o     = ptr;
+
+	o->next		   = cache->free[class];
+	cache->free[class] = o;
+	cache->count[class]++;
+	cache->in_use -= (int32_t)class_size(class);
+	if (cache->count[class] > CACHE_MAX) {
+		flush(cache, class);
+	}
+}
+
+void malloc_get_stats(struct malloc_stats *stats)
+{
+	int32_t	 in_use = 0;
+	uint32_t cached = 0;
+
+	for (unsigned int t = 0; t < MALLOC_THREADS; t++) {
+		in_use += caches[t].in_use;
+		for (unsigned int c = 0; c < CLASSES; c++) {
+			cached += caches[t].count[c] * class_size(c);
+		}
+	}
+
+	stats->heap_bytes   = heap_pages * PAGE_SIZE;
+	stats->in_use_bytes = (uint32_t)in_use;
+	stats->cached_bytes = cached;
+	stats->shared_bytes = central_bytes;
+}
@@ -0,0 +1,141 @@
+#include <user/mpmc.h>
+#include <user/syscall.h>
+#include <lib/atomic.h>
+
+void mpmc_init(struct mpmc_queue *queue, struct mpmc_cell *cells, uint32_t size)
+{
+	for (uint32_t i = 0; i < size; i++) {
+		cells[i].seq  = i;
+		cells[i].data = nullptr;
+	}
+
+	queue->cells		 = cells;
+	queue->mask		 = size - 1;
+	queue->enqueue_pos	 = 0;
+	queue->dequeue_pos	 = 0;
+	queue->push_seq		 = 0;
+	queue->pop_seq		 = 0;
+	queue->consumers_waiting = 0;
+	queue->producers_waiting = 0;
+}
+
+bool mpmc_try_push(struct mpmc_queue *queue, void *data)
+{
+	struct mpmc_cell *cell;
+	uint32_t	  pos = queue->enqueue_pos;
+
+	for (;;) {
+		cell	     = &queue->cells[pos & queue->mask];
+		uint32_t seq = cell->seq;
+		atomic_barrier();
+		int32_t diff = (int32_t)(seq - pos);
+
+		if (diff == 0) {
+			uint32_t seen = atomic_cmpxchg(&queue->enqueue_pos, pos, pos + 1);
+			if (seen == pos) {
+				break;
+			}
+			pos = seen;
+		} else if (diff < 0) {
+			// Not consumed yet since the last lap: full
+			return false;
+		} else {
+			pos = queue->enqueue_pos;
+		}
+	}
+
+	cell->data = data;
+	atomic_barrier();
+	cell->seq = pos + 1;
+	return true;
+}
+
+bool mpmc_try_pop(struct mpmc_queue *queue, void **data)
+{
+	struct mpmc_cell *cell;
+	uint32_t	  pos = queue->dequeue_pos;
+
+	for (;;) {
+		cell	     = &queue->cells[pos & queue->mask];
+		uint32_t seq = cell->seq;
+		atomic_barrier();
+		int32_t diff = (int32_t)(seq - (pos + 1));
+
+		if (diff == 0) {
+			uint32_t seen = atomic_cmpxchg(&queue->dequeue_pos, pos, pos + 1);
+			if (seen == pos) {
+				break;
+			}
+			pos = seen;
+		} else if (diff < 0) {
+			// Not produced yet: empty
+			return false;
+		} else {
+			pos = queue->dequeue_pos;
+		}
+	}
+
+	*data = cell->data;
+	atomic_barrier();
+	// Free for the producer of the same cell one lap later
+	cell->seq = pos + queue->mask + 1;
+	return true;
+}
+
+/*
+ * The waiter counts itself in and tries once more before it sleeps, a
+ * push or pop racing with it either is seen by that try or sees the
+ * waiter and bumps seq, so futex_wait returns at once.
+ */
+static void wait_for(volatile uint32_t *seq, volatile uint32_t *waiting,
+		     bool (*retry)(struct mpmc_queue *, void **), struct mpmc_queue *queue,
+		     void **data)
+{
+	for (;;) {
+		uint32_t snapshot = *seq;
+
+		atomic_add_return(waiting, 1);
+		bool done = retry(queue, data);
+		if (!done) {
+			sys_futex_wait(seq, snapshot);
+		}
+		atomic_add_return(waiting, -1);
+
+		if (done || retry(queue, data)) {
+			return;
+		}
+	}
+}
+
+static void notify(volatile uint32_t *seq, volatile uint32_t *waiting)
+{
+	atomic_barrier();
+	if (*waiting) {
+		atomic_add_return(seq, 1);
+		sys_futex_wake(seq, 1);
+	}
+}
+
+static bool retry_push(struct mpmc_queue *queue, void **data)
+{
+	return mpmc_try_push(queue, *data);
+}
+
+void mpmc_push(struct mpmc_queue *queue, void *data)
+{
+	if (!mpmc_try_push(queue, data)) {
+		wait_for(&queue->pop_seq, &queue->producers_waiting, retry_push, queue, &data);
+	}
+	notify(&queue->push_seq, &queue->consumers_waiting);
+}
+
+void *mpmc_pop(struct mpmc_queue *queue)
+{
+	void *data;
+
+	if (!mpmc_try_pop(queue, &data)) {
+		wait_for(&queue->push_seq, &queue->consumers_waiting, mpmc_try_pop, queue, &data);
+	}
+	notify(&queue->pop_seq, &queue->producers_waiting);
+	return data;
+}
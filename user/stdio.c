@@ -0,0 +1,96 @@
+#include <user/stdio.h>
+#include <user/sync.h>
+#include <user/syscall.h>
+#include <lib/kprintf.h>
+#include <stdarg.h>
+#include <stdbool.h>
+
+struct stdio_buffer {
+	char	 data[STDIO_BUFFER_SIZE];
+	uint32_t len;
+	uint32_t chars;
+	uint32_t writes;
+};
+
+static struct stdio_buffer buffers[STDIO_THREADS];
+
+static struct stdio_buffer *own_buffer(void)
+{
+	return &buffers[sync_thread_id() % STDIO_THREADS];
+}
+
+static void flush_buffer(struct stdio_buffer *buf)
+{
+	if (buf->len == 0) {
+		return;
+	}
+
+	sys_write(buf->data, buf->len);
+	buf->chars += buf->len;
+	buf->writes++;
+	buf->len = 0;
+}
+
+static void put(struct stdio_buffer *buf, char c)
+{
+	buf->data[buf->len++] = c;
+	if (c == '\n' || buf->len == STDIO_BUFFER_SIZE) {
+		flush_buffer(buf);
+	}
+}
+
+static void put_string(struct stdio_buffer *buf, const char *s)
+{
+	while (*s) {
+		put(buf, *s++);
+	}
+}
+
+int putchar(int c)
+{
+	put(own_buffer(), (char)c);
+	return c;
+}
+
+int puts(const char *s)
+{
+	struct stdio_buffer *buf = own_buffer();
+
+	put_string(buf, s);
+	put(buf, '\n');
+	return 0;
+}
+
+static void put_char(void *buf, char c)
+{
+	put(buf, c);
+}
+
+void printf(const char *fmt, ...)
+{
+	va_list args;
+
+	va_start(args, fmt);
+	vformat(put_char, own_buffer(), fmt, args);
+	va_end(args);
+}
+
+void fflush(void)
+{
+	flush_buffer(own_buffer());
+}
+
+void stdio_reset(void)
+{
+	own_buffer()->len = 0;
+}
+
+void stdio_get_stats(struct stdio_stats *stats)
+{
+	stats->chars  = 0;
+	stats->writes = 0;
+	for (unsigned int i = 0; i < STDIO_THREADS; i++) {
+		stats->chars += buffers[i].chars;
+		stats->writes += buffers[i].writes;
+	}
+}
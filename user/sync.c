@@ -0,0 +1,83 @@
+#include <user/sync.h>
+#include <user/syscall.h>
+#include <lib/atomic.h>
+
+/*
+ * Reads before each trylock so a held mutex costs no exclusive access.
+ * With one core the owner only runs again after a preemption, so the
+ * bound stays small: the spin pays off only if a tick lands inside it.
+ */
+#define MUTEX_SPIN_COUNT 16
+
+void mutex_lock(mutex_t *mutex)
+{
+	for (unsigned int i = 0; i < MUTEX_SPIN_COUNT; i++) {
+		if (!mutex->word && mutex_trylock(mutex)) {
+			return;
+		}
+	}
+	sys_futex_lock_pi(&mutex->word);
+}
+
+bool mutex_trylock(mutex_t *mutex)
+{
+	return atomic_cmpxchg(&mutex->word, 0, sync_thread_id()) == 0;
+}
+
+void mutex_unlock(mutex_t *mutex)
+{
+	uint32_t tid = sync_thread_id();
+
+	// Fails if waiters are queued, the kernel hands the mutex over then
+	if (atomic_cmpxchg(&mutex->word, tid, 0) != tid) {
+		sys_futex_unlock_pi(&mutex->word);
+	}
+}
+
+void sem_wait(sem_t *sem)
+{
+	if (sem_trywait(sem)) {
+		return;
+	}
+
+	atomic_add_return(&sem->waiters, 1);
+	while (!sem_trywait(sem)) {
+		sys_futex_wait(&sem->count, 0);
+	}
+	atomic_add_return(&sem->waiters, -1);
+}
+
+bool sem_trywait(sem_t *sem)
+{
+	return atomic_dec_if_positive(&sem->count);
+}
+
+void sem_post(sem_t *sem)
+{
+	atomic_add_return(&sem->count, 1);
+	if (sem->waiters) {
+		sys_futex_wake(&sem->count, 1);
+	}
+}
+
+void cond_wait(cond_t *cond, mutex_t *mutex)
+{
+	uint32_t seq = cond->seq;
+
+	mutex_unlock(mutex);
+	// Returns at once if a signal came in after reading seq
+	sys_futex_wait(&cond->seq, seq);
+	mutex_lock(mutex);
+}
+
+void cond_signal(cond_t *cond)
+{
+	atomic_add_return(&cond->seq, 1);
+	sys_futex_wake(&cond->seq, 1);
+}
+
+void cond_broadcast(cond_t *cond)
+{
+	atomic_add_return(&cond->seq, 1);
+	sys_futex_wake(&cond->seq, 0xFFFFFFFF);
+}
@@ -0,0 +1,137 @@
+#include <user/syscall.h>
+#include <user/stdio.h>
+#include <user/poll.h>
+
+void sys_exit [[noreturn]] (void)
+{
+	fflush();
+	asm volatile("svc %0" : : "i"(SYSCALL_EXIT));
+	__builtin_unreachable();
+}
+
+void sys_yield(void)
+{
+	asm volatile("svc %0" : : "i"(SYSCALL_YIELD) : "memory");
+}
+
+char sys_getc(void)
+{
+	register uint32_t r0 asm("r0");
+	asm volatile("svc %1" : "=r"(r0) : "i"(SYSCALL_GETC) : "memory");
+	return (char)r0;
+}
+
+char sys_input_wait(void)
+{
+	register uint32_t r0 asm("r0");
+	asm volatile("svc %1" : "=r"(r0) : "i"(SYSCALL_INPUT_WAIT) : "memory");
+	return (char)r0;
+}
+
+void sys_sleep(uint32_t ticks)
+{
+	register uint32_t r0 asm("r0") = ticks;
+	asm volatile("svc %1" : "+r"(r0) : "i"(SYSCALL_SLEEP) : "memory");
+}
+
+int sys_write(const char *buf, uint32_t len)
+{
+	register uint32_t r0 asm("r0") = (uint32_t)buf;
+	register uint32_t r1 asm("r1") = len;
+	asm volatile("svc %2" : "+r"(r0) : "r"(r1), "i"(SYSCALL_WRITE) : "memory");
+	return (int)r0;
+}
+
+int sys_rt_set(uint32_t runtime, uint32_t period, uint32_t deadline)
+{
+	register uint32_t r0 asm("r0") = runtime;
+	register uint32_t r1 asm("r1") = period;
+	register uint32_t r2 asm("r2") = deadline;
+	asm volatile("svc %3" : "+r"(r0) : "r"(r1), "r"(r2), "i"(SYSCALL_RT_SET) : "memory");
+	return (int)r0;
+}
+
+void sys_rt_wait(void)
+{
+	asm volatile("svc %0" : : "i"(SYSCALL_RT_WAIT) : "memory");
+}
+
+int sys_futex_wait(volatile uint32_t *addr, uint32_t expected)
+{
+	register uint32_t r0 asm("r0") = (uint32_t)addr;
+	register uint32_t r1 asm("r1") = expected;
+	asm volatile("svc %2" : "+r"(r0) : "r"(r1), "i"(SYSCALL_FUTEX_WAIT) : "memory");
+	return (int)r0;
+}
+
+int sys_futex_wake(volatile uint32_t *addr, uint32_t count)
+{
+	register uint32_t r0 asm("r0") = (uint32_t)addr;
+	register uint32_t r1 asm("r1") = count;
+	asm volatile("svc %2" : "+r"(r0) : "r"(r1), "i"(SYSCALL_FUTEX_WAKE) : "memory");
+	return (int)r0;
+}
+
+int sys_futex_lock_pi(volatile uint32_t *addr)
+{
+	register uint32_t r0 asm("r0") = (uint32_t)addr;
+	asm volatile("svc %1" : "+r"(r0) : "i"(SYSCALL_FUTEX_LOCK_PI) : "memory");
+	return (int)r0;
+}
+
+int sys_futex_unlock_pi(volatile uint32_t *addr)
+{
+	register uint32_t r0 asm("r0") = (uint32_t)addr;
+	asm volatile("svc %1" : "+r"(r0) : "i"(SYSCALL_FUTEX_UNLOCK_PI) : "memory");
+	return (int)r0;
+}
+
+void *sys_sbrk(int32_t pages)
+{
+	register uint32_t r0 asm("r0") = (uint32_t)pages;
+	asm volatile("svc %1" : "+r"(r0) : "i"(SYSCALL_SBRK) : "memory");
+	return (void *)r0;
+}
+
+const struct time_page *sys_time_page(void)
+{
+	register uint32_t r0 asm("r0");
+	asm volatile("svc %1" : "=r"(r0) : "i"(SYSCALL_TIME_PAGE) : "memory");
+	return (const struct time_page *)r0;
+}
+
+uint32_t sys_time_us(void)
+{
+	register uint32_t r0 asm("r0");
+	asm volatile("svc %1" : "=r"(r0) : "i"(SYSCALL_TIME) : "memory");
+	return r0;
+}
+
+int sys_uring_setup(struct uring *ring, uint32_t flags)
+{
+	register uint32_t r0 asm("r0") = (uint32_t)ring;
+	register uint32_t r1 asm("r1") = flags;
+	asm volatile("svc %2" : "+r"(r0) : "r"(r1), "i"(SYSCALL_URING_SETUP) : "memory");
+	return (int)r0;
+}
+
+int sys_uring_enter(int id, uint32_t min_complete)
+{
+	register uint32_t r0 asm("r0") = (uint32_t)id;
+	register uint32_t r1 asm("r1") = min_complete;
+	asm volatile("svc %2" : "+r"(r0) : "r"(r1), "i"(SYSCALL_URING_ENTER) : "memory");
+	return (int)r0;
+}
+
+uint32_t sys_poll(uint32_t events, uint32_t timeout_us)
+{
+	register uint32_t r0 asm("r0") = events;
+	register uint32_t r1 asm("r1") = timeout_us;
+	asm volatile("svc %2" : "+r"(r0) : "r"(r1), "i"(SYSCALL_POLL) : "memory");
+	return r0;
+}
+
+void sys_null(void)
+{
+	asm volatile("svc %0" : : "i"(SYSCALL_NULL) : "memory");
+}
@@ -0,0 +1,13 @@
+#include <user/thread.h>
+#include <user/stdio.h>
+#include <user/syscall.h>
+
+void thread_entry [[noreturn]] (void (*func)(void *), void *arg)
+{
+	// The slot may have been left by a thread that was killed mid-line
+	stdio_reset();
+	func(arg);
+
+	// Flushes the stdio buffer of the thread on the way out
+	sys_exit();
+}
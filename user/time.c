@@ -0,0 +1,45 @@
+#include <user/time.h>
+#include <user/syscall.h>
+#include <lib/atomic.h>
+
+static const struct time_page *page = nullptr;
+
+static const struct time_page *time_page(void)
+{
+	if (!page) {
+		page = sys_time_page();
+	}
+	return page;
+}
+
+uint64_t time_now_us(void)
+{
+	const struct time_page *tp = time_page();
+	uint32_t		seq;
+	uint64_t		us;
+
+	do {
+		seq = tp->seq;
+		atomic_barrier();
+		us = tp->us + time_page_extrapolate(tp, time_cycles());
+		atomic_barrier();
+	} while ((seq & 1) || tp->seq != seq);
+
+	return us;
+}
+
+uint32_t time_jiffies(void)
+{
+	const struct time_page *tp = time_page();
+	uint32_t		seq;
+	uint32_t		jiffies;
+
+	do {
+		seq = tp->seq;
+		atomic_barrier();
+		jiffies = tp->jiffies;
+		atomic_barrier();
+	} while ((seq & 1) || tp->seq != seq);
+
+	return jiffies;
+}
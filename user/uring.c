@@ -0,0 +1,59 @@
+#include <user/uring.h>
+#include <user/syscall.h>
+#include <lib/atomic.h>
+
+int uring_setup(struct uring *ring, uint32_t flags)
+{
+	return sys_uring_setup(ring, flags);
+}
+
+struct uring_sqe *uring_get_sqe(struct uring *ring)
+{
+	if (ring->sqe_tail - ring->sq_head >= URING_ENTRIES) {
+		return nullptr;
+	}
+
+	// Only becomes visible to the kernel with the next submit
+	return &ring->sq[ring->sqe_tail++ % URING_ENTRIES];
+}
+
+/* Publishes the new entries, true if the kernel has to be told */
+static bool publish(struct uring *ring)
+{
+	atomic_barrier();
+	ring->sq_tail = ring->sqe_tail;
+	atomic_barrier();
+	return !ring->sqpoll || (ring->flags & URING_NEED_WAKEUP);
+}
+
+void uring_submit(struct uring *ring)
+{
+	if (publish(ring)) {
+		sys_uring_enter(ring->id, 0);
+	}
+}
+
+void uring_submit_and_wait(struct uring *ring, uint32_t count)
+{
+	bool enter = publish(ring);
+
+	if (enter || ring->cq_tail - ring->cq_head < count) {
+		sys_uring_enter(ring->id, count);
+	}
+}
+
+struct uring_cqe *uring_peek_cqe(struct uring *ring)
+{
+	if (ring->cq_head == ring->cq_tail) {
+		return nullptr;
+	}
+
+	atomic_barrier();
+	return &ring->cq[ring->cq_head % URING_ENTRIES];
+}
+
+void uring_cqe_seen(struct uring *ring)
+{
+	atomic_barrier();
+	ring->cq_head++;
+}